@@ -0,0 +1,85 @@
+#include "ecs/world.hpp"
+#include "utils/timer.hpp"
+
+#include <iostream>
+#include <vector>
+
+// =============================================================================
+// Components
+// =============================================================================
+
+struct Position { float x, y; };
+struct Velocity { float x, y; };
+struct Health   { int hp; };
+struct Enemy    {};
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+void registerComponents(ECS::World& world) {
+    world.registerComponent<Position>();
+    world.registerComponent<Velocity>();
+    world.registerComponent<Health>();
+    world.registerComponent<Enemy>();
+}
+
+// runs fn on a fresh world `reps` times and returns the best time in seconds
+template <typename Fn>
+double timeBest(int reps, Fn&& fn) {
+    double best = 1e30;
+    for (int r = 0; r < reps; r++) {
+        ECS::World world;
+        registerComponents(world);
+
+        Timer timer;
+        fn(world);
+        double elapsed = timer.elapsed();
+
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+// =============================================================================
+// Benchmark
+// =============================================================================
+
+int main() {
+    const int reps = 10;
+    const std::vector<size_t> waveSizes = {1000, 5000, 20000, 100000};
+
+    const Position pos{0.0f, 0.0f};
+    const Velocity vel{1.0f, 0.0f};
+    const Health   hp {100};
+
+    for (size_t n : waveSizes) {
+
+        // one entity at a time
+        double single = timeBest(reps, [&](ECS::World& world) {
+            for (size_t i = 0; i < n; i++)
+                world.createEntityInGroup(0, pos, vel, hp, Enemy{});
+        });
+
+        // whole chunks filled from prototypes
+        double bulk = timeBest(reps, [&](ECS::World& world) {
+            world.createEntities(n, 0, pos, vel, hp, Enemy{});
+        });
+
+        // whole chunks filled from column arrays
+        std::vector<Position> positions(n, pos);
+        std::vector<Velocity> velocities(n, vel);
+        std::vector<Health>   healths(n, hp);
+        double columns = timeBest(reps, [&](ECS::World& world) {
+            world.createEntitiesFromColumns(n, 0, positions.data(), velocities.data(), healths.data());
+        });
+
+        std::cout << "entities: " << n << std::endl;
+        std::cout << "  single:  " << n / single  << " entities/s" << std::endl;
+        std::cout << "  bulk:    " << n / bulk    << " entities/s" << std::endl;
+        std::cout << "  columns: " << n / columns << " entities/s" << std::endl;
+        std::cout << "  speedup: " << single / bulk << "x" << std::endl;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "ecs/world.hpp"
+#include "utils/timer.hpp"
+
+#include <iostream>
+#include <vector>
+
+// =============================================================================
+// Components
+// =============================================================================
+
+struct Position { float x, y; };
+struct Velocity { float x, y; };
+struct Health   { int hp; };
+struct Enemy    {};
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+const ECS::GroupID ENEMY_GROUP = 1;
+
+// spawns a night wave next to some long lived entities that must survive
+std::vector<ECS::EntityID> spawnWave(ECS::World& world, size_t n) {
+    world.registerComponent<Position>();
+    world.registerComponent<Velocity>();
+    world.registerComponent<Health>();
+    world.registerComponent<Enemy>();
+    world.createEntities(1000, 0, Position{}, Velocity{}, Health{50});
+    return world.createEntities(n, ENEMY_GROUP, Position{}, Velocity{}, Health{100}, Enemy{});
+}
+
+// runs fn on a freshly spawned wave `reps` times and returns the best time in seconds
+template <typename Fn>
+double timeBest(int reps, size_t n, Fn&& fn) {
+    double best = 1e30;
+    for (int r = 0; r < reps; r++) {
+        ECS::World world;
+        std::vector<ECS::EntityID> wave = spawnWave(world, n);
+
+        Timer timer;
+        fn(world, wave);
+        double elapsed = timer.elapsed();
+
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+// =============================================================================
+// Benchmark
+// =============================================================================
+
+int main() {
+    const int reps = 10;
+    const std::vector<size_t> waveSizes = {1000, 5000, 20000, 100000};
+
+    for (size_t n : waveSizes) {
+
+        // one entity at a time
+        double single = timeBest(reps, n, [](ECS::World& world, const std::vector<ECS::EntityID>& wave) {
+            for (ECS::EntityID eID : wave)
+                world.removeEntity(eID);
+        });
+
+        // whole chunks released by query
+        double matching = timeBest(reps, n, [](ECS::World& world, const std::vector<ECS::EntityID>&) {
+            auto enemies = world.query<ECS::With<Enemy>>();
+            world.destroyMatching(enemies);
+        });
+
+        // whole chunks released by group
+        double group = timeBest(reps, n, [](ECS::World& world, const std::vector<ECS::EntityID>&) {
+            world.destroyGroup(ENEMY_GROUP);
+        });
+
+        std::cout << "entities: " << n << std::endl;
+        std::cout << "  single:   " << single   * 1e3 << " ms" << std::endl;
+        std::cout << "  matching: " << matching * 1e3 << " ms" << std::endl;
+        std::cout << "  group:    " << group    * 1e3 << " ms" << std::endl;
+    }
+
+    return 0;
+}
\ No newline at end of file
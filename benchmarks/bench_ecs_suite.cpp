@@ -0,0 +1,433 @@
+#include "core/entity_manager.hpp"
+#include "ecs/world.hpp"
+#include "utils/timer.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility> // for std::index_sequence
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+    #include <sys/resource.h>
+#endif
+
+// =============================================================================
+// ECS Benchmark Suite
+//
+// Reproducible scenarios comparing ECS::World against the legacy SoA
+// EntityManager in core/ (where it has an equivalent operation):
+//
+//   churn          create then destroy entities one at a time
+//   iterate_N      update N components (1 to 4) of every entity
+//   fragment_*     many archetypes holding few entities each
+//   migrate_*      move entities between groups
+//   get_entity     random access lookups of an entity's component
+//
+// Every scenario runs on a fresh world with fixed sizes and seeds and reports
+// the best of several repetitions, so runs on one machine can be compared
+// commit to commit. Each op touches one entity. Results are printed as JSON
+// (or written to the path given as the first argument):
+//
+//   { "benchmarks": [ { "scenario": "iterate_2", "impl": "ecs",
+//     "entities": 100000, "ops": 100000, "ns_per_op": 0.41,
+//     "entities_per_s": 2.4e9, "peak_memory_bytes": 31457280 }, ... ] }
+//
+// NOTE: the legacy EntityManager uses 16 bit IDs so it only runs below 65535
+//       entities. Peak memory is the process high-water mark, which is reset
+//       before each scenario on Linux only.
+// =============================================================================
+
+// =============================================================================
+// Components
+// =============================================================================
+
+struct Position { float x, y; };
+struct Velocity { float x, y; };
+struct Force    { float x, y; };
+struct Mass     { float inv; };
+
+template <size_t I> struct Tag {};
+
+constexpr size_t TAG_COUNT = 8; // 256 archetypes
+
+// fixed IDs, twelve unlisted types would collide for a small ECS_MAX_COMPONENTS
+ECS_COMPONENT_ID(Position, 0);
+ECS_COMPONENT_ID(Velocity, 1);
+ECS_COMPONENT_ID(Force,    2);
+ECS_COMPONENT_ID(Mass,     3);
+ECS_COMPONENT_ID(Tag<0>,   4);
+ECS_COMPONENT_ID(Tag<1>,   5);
+ECS_COMPONENT_ID(Tag<2>,   6);
+ECS_COMPONENT_ID(Tag<3>,   7);
+ECS_COMPONENT_ID(Tag<4>,   8);
+ECS_COMPONENT_ID(Tag<5>,   9);
+ECS_COMPONENT_ID(Tag<6>,   10);
+ECS_COMPONENT_ID(Tag<7>,   11);
+static_assert(TAG_COUNT == 8, "List every Tag with ECS_COMPONENT_ID.");
+
+template <size_t... Is>
+void registerTags(ECS::World& world, std::index_sequence<Is...>) {
+    (world.registerComponent<Tag<Is>>(), ...);
+}
+
+void registerComponents(ECS::World& world) {
+    world.registerComponent<Position>();
+    world.registerComponent<Velocity>();
+    world.registerComponent<Force>();
+    world.registerComponent<Mass>();
+    registerTags(world, std::make_index_sequence<TAG_COUNT>{});
+}
+
+// inserts Tag<I> for every bit I set in mask
+template <size_t... Is>
+void insertTags(ECS::World& world, ECS::EntityID eID, size_t mask, std::index_sequence<Is...>) {
+    ((mask & (size_t(1) << Is) ? world.insertComponentIntoEntity(eID, Tag<Is>{}) : void()), ...);
+}
+
+// =============================================================================
+// Measurement
+// =============================================================================
+
+struct Result {
+    std::string scenario;
+    std::string impl;
+    size_t entities;
+    size_t ops;
+    double seconds;
+    size_t peakMemory;
+};
+
+std::vector<Result> results;
+
+// resets the peak resident set size to the current one (Linux only)
+void resetPeakMemory() {
+#if defined(__linux__)
+    std::ofstream file("/proc/self/clear_refs");
+    if (file.is_open()) file << "5";
+#endif
+}
+
+size_t getPeakMemory() {
+#if defined(__linux__)
+    std::ifstream file("/proc/self/status");
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::stoull(line.substr(6)) * 1024;
+        }
+    }
+    return 0;
+#elif defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss); // bytes on macOS
+#else
+    return 0;
+#endif
+}
+
+// runs setup() then the timed fn(state) `reps` times on fresh state and
+// records the best time
+template <typename Setup, typename Fn>
+void run(const std::string& scenario, const std::string& impl, size_t entities, size_t ops, int reps, Setup&& setup, Fn&& fn) {
+    double best = 1e30;
+    resetPeakMemory();
+
+    for (int r = 0; r < reps; r++) {
+        auto state = setup();
+
+        Timer timer;
+        fn(*state);
+        double elapsed = timer.elapsed();
+
+        if (elapsed < best) best = elapsed;
+    }
+
+    results.push_back({scenario, impl, entities, ops, best, getPeakMemory()});
+    std::fprintf(stderr, "%-16s %-6s %8zu entities %10.3f ns/op\n", scenario.c_str(), impl.c_str(), entities, best * 1e9 / ops);
+}
+
+std::string toJSON() {
+    std::ostringstream out;
+    out << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result& r = results[i];
+        out << "    {\"scenario\": \"" << r.scenario << "\", "
+            << "\"impl\": \"" << r.impl << "\", "
+            << "\"entities\": " << r.entities << ", "
+            << "\"ops\": " << r.ops << ", "
+            << "\"ns_per_op\": " << r.seconds * 1e9 / r.ops << ", "
+            << "\"entities_per_s\": " << r.ops / r.seconds << ", "
+            << "\"peak_memory_bytes\": " << r.peakMemory << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return out.str();
+}
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+constexpr size_t LEGACY_CAPACITY = 65534;
+constexpr unsigned int SEED = 12345;
+
+std::unique_ptr<ECS::World> makeWorld() {
+    auto world = std::make_unique<ECS::World>();
+    registerComponents(*world);
+    return world;
+}
+
+std::unique_ptr<ECS::World> makeMovers(size_t n) {
+    auto world = makeWorld();
+    world->createEntities(n, 0, Position{0.0f, 0.0f}, Velocity{1.0f, 0.5f}, Force{0.0f, -1.0f}, Mass{0.5f});
+    return world;
+}
+
+std::unique_ptr<EntityManager> makeLegacy(size_t n) {
+    auto em = std::make_unique<EntityManager>();
+    for (size_t i = 0; i < n; i++) {
+        em->createEntity(EntityType::RED, {0.0f, 0.0f});
+    }
+    return em;
+}
+
+// =============================================================================
+// Scenarios
+// =============================================================================
+
+void benchChurn(size_t n, int reps) {
+    const int cycles = 10;
+    const size_t ops = 2 * n * cycles;
+
+    run("churn", "ecs", n, ops, reps, makeWorld, [&](ECS::World& world) {
+        std::vector<ECS::EntityID> ids(n);
+        for (int c = 0; c < cycles; c++) {
+            for (size_t i = 0; i < n; i++)
+                ids[i] = world.createEntity(Position{0.0f, 0.0f}, Velocity{1.0f, 0.5f});
+            for (size_t i = 0; i < n; i++)
+                world.removeEntity(ids[i]);
+        }
+    });
+
+    if (n > LEGACY_CAPACITY) return;
+
+    run("churn", "legacy", n, ops, reps, [] { return makeLegacy(0); }, [&](EntityManager& em) {
+        std::vector<::EntityID> ids(n);
+        for (int c = 0; c < cycles; c++) {
+            for (size_t i = 0; i < n; i++)
+                ids[i] = em.createEntity(EntityType::RED, {0.0f, 0.0f});
+            for (size_t i = 0; i < n; i++)
+                em.removeEntity(ids[i]);
+        }
+    });
+}
+
+void benchIterate(size_t n, int reps) {
+    const int passes = 10;
+    const size_t ops = n * passes;
+    const float dt = 1.0f / 60.0f;
+
+    auto setup = [&] { return makeMovers(n); };
+
+    run("iterate_1", "ecs", n, ops, reps, setup, [&](ECS::World& world) {
+        for (int p = 0; p < passes; p++) {
+            world.forEachChunk<Position>([&](ECS::ChunkIdx count, Position* ECS_RESTRICT pos) {
+                for (ECS::ChunkIdx i = 0; i < count; i++) {
+                    pos[i].x += dt;
+                    pos[i].y += dt;
+                }
+            });
+        }
+    });
+
+    run("iterate_2", "ecs", n, ops, reps, setup, [&](ECS::World& world) {
+        for (int p = 0; p < passes; p++) {
+            world.forEachChunk<Position, const Velocity>([&](ECS::ChunkIdx count, Position* ECS_RESTRICT pos, const Velocity* ECS_RESTRICT vel) {
+                for (ECS::ChunkIdx i = 0; i < count; i++) {
+                    pos[i].x += vel[i].x * dt;
+                    pos[i].y += vel[i].y * dt;
+                }
+            });
+        }
+    });
+
+    run("iterate_3", "ecs", n, ops, reps, setup, [&](ECS::World& world) {
+        for (int p = 0; p < passes; p++) {
+            world.forEachChunk<Position, Velocity, const Force>([&](ECS::ChunkIdx count, Position* ECS_RESTRICT pos, Velocity* ECS_RESTRICT vel, const Force* ECS_RESTRICT force) {
+                for (ECS::ChunkIdx i = 0; i < count; i++) {
+                    vel[i].x += force[i].x * dt;
+                    vel[i].y += force[i].y * dt;
+                    pos[i].x += vel[i].x * dt;
+                    pos[i].y += vel[i].y * dt;
+                }
+            });
+        }
+    });
+
+    run("iterate_4", "ecs", n, ops, reps, setup, [&](ECS::World& world) {
+        for (int p = 0; p < passes; p++) {
+            world.forEachChunk<Position, Velocity, const Force, const Mass>([&](ECS::ChunkIdx count, Position* ECS_RESTRICT pos, Velocity* ECS_RESTRICT vel, const Force* ECS_RESTRICT force, const Mass* ECS_RESTRICT mass) {
+                for (ECS::ChunkIdx i = 0; i < count; i++) {
+                    vel[i].x += force[i].x * mass[i].inv * dt;
+                    vel[i].y += force[i].y * mass[i].inv * dt;
+                    pos[i].x += vel[i].x * dt;
+                    pos[i].y += vel[i].y * dt;
+                }
+            });
+        }
+    });
+
+    if (n > LEGACY_CAPACITY) return;
+
+    // NOTE: the legacy update moves positions by velocities (2 components)
+    run("iterate_2", "legacy", n, ops, reps, [&] { return makeLegacy(n); }, [&](EntityManager& em) {
+        for (int p = 0; p < passes; p++) {
+            em.updateEntities();
+        }
+    });
+}
+
+// every combination of TAG_COUNT tags is its own archetype
+void benchFragmentation(size_t perArchetype, int reps) {
+    const size_t archetypes = size_t(1) << TAG_COUNT;
+    const size_t n = archetypes * perArchetype;
+    const int passes = 100;
+
+    run("fragment_create", "ecs", n, n, reps, makeWorld, [&](ECS::World& world) {
+        for (size_t a = 0; a < archetypes; a++) {
+            for (size_t i = 0; i < perArchetype; i++) {
+                ECS::EntityID eID = world.createEntity(Position{0.0f, 0.0f}, Velocity{1.0f, 0.5f});
+                insertTags(world, eID, a, std::make_index_sequence<TAG_COUNT>{});
+            }
+        }
+    });
+
+    auto setup = [&] {
+        auto world = makeWorld();
+        for (size_t a = 0; a < archetypes; a++) {
+            for (size_t i = 0; i < perArchetype; i++) {
+                ECS::EntityID eID = world->createEntity(Position{0.0f, 0.0f}, Velocity{1.0f, 0.5f});
+                insertTags(*world, eID, a, std::make_index_sequence<TAG_COUNT>{});
+            }
+        }
+        return world;
+    };
+
+    run("fragment_iterate", "ecs", n, n * passes, reps, setup, [&](ECS::World& world) {
+        for (int p = 0; p < passes; p++) {
+            world.forEachChunk<Position, const Velocity>([](ECS::ChunkIdx count, Position* ECS_RESTRICT pos, const Velocity* ECS_RESTRICT vel) {
+                for (ECS::ChunkIdx i = 0; i < count; i++) {
+                    pos[i].x += vel[i].x;
+                    pos[i].y += vel[i].y;
+                }
+            });
+        }
+    });
+}
+
+void benchMigration(size_t n, int reps) {
+    struct State {
+        std::unique_ptr<ECS::World> world;
+        std::vector<ECS::EntityID> ids;
+    };
+
+    auto setup = [&] {
+        auto state = std::make_unique<State>();
+        state->world = makeWorld();
+        state->ids = state->world->createEntities(n, 0, Position{0.0f, 0.0f}, Velocity{1.0f, 0.5f});
+        return state;
+    };
+
+    run("migrate_single", "ecs", n, n, reps, setup, [&](State& s) {
+        for (ECS::EntityID eID : s.ids)
+            s.world->moveEntityToGroup(eID, 1);
+    });
+
+    // every row moves so whole chunks are relinked
+    run("migrate_batch", "ecs", n, n, reps, setup, [&](State& s) {
+        s.world->moveEntitiesToGroup(s.ids.data(), s.ids.size(), 1);
+    });
+
+    // every other row moves so rows are copied
+    run("migrate_half", "ecs", n, n / 2, reps, setup, [&](State& s) {
+        std::vector<ECS::EntityID> half;
+        for (size_t i = 0; i < s.ids.size(); i += 2)
+            half.push_back(s.ids[i]);
+        s.world->moveEntitiesToGroup(half.data(), half.size(), 1);
+    });
+}
+
+void benchGetEntity(size_t n, int reps) {
+    const size_t lookups = 1000000;
+
+    struct State {
+        std::unique_ptr<ECS::World> world;
+        std::vector<ECS::EntityID> order;
+        float sum;
+    };
+
+    auto setup = [&] {
+        auto state = std::make_unique<State>();
+        state->world = makeWorld();
+        std::vector<ECS::EntityID> ids = state->world->createEntities(n, 0, Position{1.0f, 2.0f}, Velocity{1.0f, 0.5f});
+
+        std::mt19937 rng(SEED);
+        std::uniform_int_distribution<size_t> pick(0, n - 1);
+        state->order.resize(lookups);
+        for (ECS::EntityID& eID : state->order)
+            eID = ids[pick(rng)];
+
+        state->sum = 0.0f;
+        return state;
+    };
+
+    run("get_entity", "ecs", n, lookups, reps, setup, [&](State& s) {
+        ECS::World& world = *s.world;
+        float sum = 0.0f;
+        for (ECS::EntityID eID : s.order) {
+            const ECS::Entity& e = world.getEntity(eID);
+            const ECS::Chunk& chunk = world.getChunk(e.getChunkID());
+            sum += chunk.data<Position>()[e.getChunkIdx()].x;
+        }
+        s.sum = sum; // keep the loop alive
+    });
+}
+
+// =============================================================================
+// Benchmark
+// =============================================================================
+
+int main(int argc, char** argv) {
+    const int reps = 5;
+
+    for (size_t n : {10000, 100000})
+        benchChurn(n, reps);
+
+    for (size_t n : {10000, 50000, 100000, 1000000})
+        benchIterate(n, reps);
+
+    for (size_t perArchetype : {1, 16})
+        benchFragmentation(perArchetype, reps);
+
+    for (size_t n : {10000, 100000})
+        benchMigration(n, reps);
+
+    for (size_t n : {10000, 100000, 1000000})
+        benchGetEntity(n, reps);
+
+    std::string json = toJSON();
+    if (argc > 1) {
+        std::ofstream file(argv[1]);
+        file << json;
+    } else {
+        std::fputs(json.c_str(), stdout);
+    }
+
+    return 0;
+}
\ No newline at end of file
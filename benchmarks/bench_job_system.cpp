@@ -0,0 +1,130 @@
+#include "ecs/world.hpp"
+#include "utils/job_system.hpp"
+#include "utils/timer.hpp"
+
+#include <algorithm> // for std::max
+#include <atomic>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// =============================================================================
+// Components
+// =============================================================================
+
+struct Position { float x, y; };
+struct Velocity { float x, y; };
+
+// =============================================================================
+// Helpers
+// =============================================================================
+
+// runs fn `reps` times and returns the best time in seconds
+template <typename Fn>
+double timeBest(int reps, Fn&& fn) {
+    double best = 1e30;
+    for (int r = 0; r < reps; r++) {
+        Timer timer;
+        fn();
+        double elapsed = timer.elapsed();
+
+        if (elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+// compute bound work per element, uneven so the splitting has to balance it
+float work(size_t i) {
+    float x = float(i & 1023);
+    size_t steps = 64 + (i % 7) * 32;
+    for (size_t s = 0; s < steps; s++) x = std::sqrt(x * x + 1.0f);
+    return x;
+}
+
+// =============================================================================
+// Benchmark
+// =============================================================================
+
+int main() {
+    const int reps = 10;
+    const size_t jobCount = 100000;
+    const size_t n = 1 << 18;
+    const size_t units = 200000;
+    const size_t maxThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    std::vector<float> out(n);
+
+    // overhead per job, measured on all threads
+    {
+        JobSystem jobs;
+
+        double spawn = timeBest(reps, [&] {
+            JobCounter counter;
+            for (size_t i = 0; i < jobCount; i++) jobs.run([] {}, &counter);
+            jobs.wait(counter);
+        });
+
+        double range = timeBest(reps, [&] {
+            jobs.parallelFor(0, jobCount, [](size_t, size_t) {});
+        });
+
+        std::cout << "overhead (" << jobs.getThreadCount() << " threads):" << std::endl;
+        std::cout << "  run + wait:  " << spawn * 1e9 / jobCount << " ns/job" << std::endl;
+        std::cout << "  parallelFor: " << range * 1e9 / jobCount << " ns/index" << std::endl;
+    }
+
+    // parallelFor speedup over one thread
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    double single = 0.0;
+    std::cout << "scaling (" << n << " elements):" << std::endl;
+    for (size_t threads : threadCounts) {
+        JobSystem jobs(threads);
+
+        double time = timeBest(reps, [&] {
+            jobs.parallelFor(0, n, [&](size_t beg, size_t end) {
+                for (size_t i = beg; i < end; i++) out[i] = work(i);
+            });
+        });
+        if (threads == 1) single = time;
+
+        std::cout << "  threads: " << threads << std::endl;
+        std::cout << "    time:    " << time * 1e3 << " ms" << std::endl;
+        std::cout << "    speedup: " << single / time << "x" << std::endl;
+    }
+
+    // Query::parallelForEach() movement pass, partially full chunks from
+    // several groups
+    ECS::World world;
+    world.registerComponent<Position>();
+    world.registerComponent<Velocity>();
+    for (ECS::GroupID g = 0; g < 8; g++) {
+        world.createEntities(units / 8 - g * 100, g, Position{0.0f, 0.0f}, Velocity{1.0f, 0.5f});
+    }
+    auto moving = world.query<Position, const Velocity>();
+
+    std::cout << "movement (" << moving.getEntityCount() << " entities):" << std::endl;
+    for (size_t threads : threadCounts) {
+        JobSystem jobs(threads);
+
+        double time = timeBest(reps, [&] {
+            moving.parallelForEach(jobs, [](ECS::ChunkIdx count, const ECS::EntityID*,
+                    Position* pos, const Velocity* vel) {
+                for (ECS::ChunkIdx i = 0; i < count; i++) {
+                    pos[i].x += vel[i].x * 0.016f;
+                    pos[i].y += vel[i].y * 0.016f;
+                }
+            });
+        });
+        if (threads == 1) single = time;
+
+        std::cout << "  threads: " << threads << std::endl;
+        std::cout << "    time:    " << time * 1e6 << " us" << std::endl;
+        std::cout << "    speedup: " << single / time << "x" << std::endl;
+    }
+
+    return 0;
+}
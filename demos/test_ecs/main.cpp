@@ -15,7 +15,7 @@ int main() {
 
     ecs.registerComponent<Position>();
     ecs.registerComponent<Velocity>();
-    ecs.registerComponent<Disabled>();
+    ecs.registerEnableableComponent<Disabled>();
 
     ecs.createEntity(Position{ 1.0f,  2.0f}, Velocity{ 3.0f,  4.0f});
     ecs.createEntity(Position{ 5.0f,  6.0f}, Velocity{ 7.0f,  8.0f});
@@ -25,34 +25,58 @@ int main() {
 
     ecs.createEntity(Position{13.0f, 14.0f});
 
+    ecs.insertComponentIntoEntity<Disabled>(0);
+
 
 
     ecs.print();
 
-    ECS::Chunk chunk0 = ecs.getChunk(0);
-    int count0 = chunk0.getCount();
-    auto* eID0 = chunk0.getEntityIDs();
-    auto* pos0 = chunk0.data<Position>();
-    auto* vel0 = chunk0.data<Velocity>();
-    for (int i = 0; i < count0; i++) {
-        if (i == 1) {
-            pos0[i].x = 69.0f;
+    auto movers = ecs.query<Position, const Velocity, ECS::Without<Disabled>>();
+    movers.forEach([](ECS::ChunkIdx count, const ECS::EntityID* ids, Position* pos, const Velocity* vel) {
+        for (ECS::ChunkIdx i = 0; i < count; i++) {
+            pos[i].x += vel[i].x;
+            pos[i].y += vel[i].y;
+            std::cout << ids[i] << std::endl;
+            std::cout << pos[i].x << ", " << pos[i].y << std::endl;
+            std::cout << vel[i].x << ", " << vel[i].y << std::endl;
+            std::cout << std::endl;
+        }
+    });
+
+    // switching Disabled off lets entity 0 move without changing its archetype
+    ecs.setComponentEnabled<Disabled>(0, false);
+    movers.forEach([](ECS::ChunkIdx count, const ECS::EntityID* ids, Position* pos, const Velocity* vel) {
+        for (ECS::ChunkIdx i = 0; i < count; i++) {
+            pos[i].x += vel[i].x;
+            pos[i].y += vel[i].y;
+            std::cout << ids[i] << std::endl;
+            std::cout << pos[i].x << ", " << pos[i].y << std::endl;
+            std::cout << std::endl;
+        }
+    });
+
+    auto positions = ecs.query<const Position, ECS::Optional<Velocity>>();
+    positions.forEach([](ECS::ChunkIdx count, const ECS::EntityID* ids, const Position* pos, Velocity* vel) {
+        for (ECS::ChunkIdx i = 0; i < count; i++) {
+            std::cout << ids[i] << std::endl;
+            std::cout << pos[i].x << ", " << pos[i].y << std::endl;
+            if (vel) std::cout << vel[i].x << ", " << vel[i].y << std::endl;
+            std::cout << std::endl;
         }
-        std::cout << eID0[i] << std::endl;
-        std::cout << pos0[i].x << ", " << pos0[i].y << std::endl;
-        std::cout << vel0[i].x << ", " << vel0[i].y << std::endl;
-        std::cout << std::endl;
-    }
-
-    ECS::Chunk chunk1 = ecs.getChunk(1);
-    int count1 = chunk1.getCount();
-    auto* eID1 = chunk1.getEntityIDs();
-    auto* pos1 = chunk1.data<Position>();
-    for (int i = 0; i < count1; i++) {
-        std::cout << eID1[i] << std::endl;
-        std::cout << pos1[i].x << ", " << pos1[i].y << std::endl;
-        std::cout << std::endl;
-    }
+    });
+
+    // destroyMatching() keeps the rows the query skips: of 10 entities with
+    // Disabled switched off on 5, only those 5 are destroyed
+    std::vector<ECS::EntityID> units;
+    for (int i = 0; i < 10; i++) units.push_back(ecs.createEntity(Position{float(i), 0.0f}, Disabled{}));
+    for (int i = 0; i < 10; i += 2) ecs.setComponentEnabled<Disabled>(units[i], false);
+
+    auto idle = ecs.query<const Position, ECS::With<Disabled>>();
+    ecs.destroyMatching(idle);
+
+    int alive = 0;
+    for (ECS::EntityID eID : units) alive += ecs.hasEntity(eID);
+    std::cout << "units left: " << alive << std::endl;
 
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "ecs/types.hpp"
+
+// =============================================================================
+// Hierarchy Components
+//
+// Parent is a per entity component naming the parent entity and its
+// generation, so a freed and reused entity ID is not mistaken for the parent
+// (see HierarchySystem). LocalOffset is the position of a child relative to
+// its parent (e.g. its slot in the formation).
+//
+// The children of a parent are the runs of rows holding its Parent value.
+// Children created or attached together are appended to the same chunks, so
+// a formation is a contiguous child range and the parent is read once per run
+// instead of once per child.
+// =============================================================================
+
+struct Parent {
+    ECS::EntityID entity;
+    ECS::EntityGeneration generation;
+};
+
+struct LocalOffset {
+    float x, y;
+};
+
+static_assert(sizeof(Parent)      == sizeof(ECS::EntityID) + sizeof(ECS::EntityGeneration), "Parent must be tightly packed.");
+static_assert(sizeof(LocalOffset) == 2 * sizeof(float),     "LocalOffset must be tightly packed.");
+
+// stable IDs so snapshots map columns without a remap
+ECS_COMPONENT_ID(Parent,      3);
+ECS_COMPONENT_ID(LocalOffset, 4);
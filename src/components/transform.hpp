@@ -0,0 +1,32 @@
+#pragma once
+
+#include "ecs/types.hpp"
+
+// =============================================================================
+// Transform Components
+//
+// Plain data, laid out so that a column of them is a flat float array (e.g.
+// Position column = x0, y0, x1, y1, ...) which SIMD kernels can stream over.
+// =============================================================================
+
+struct Position {
+    float x, y;
+};
+
+struct Velocity {
+    float x, y;
+};
+
+// axis aligned box in world space, kept centered on the entity Position
+struct Bounds {
+    float minX, minY, maxX, maxY;
+};
+
+static_assert(sizeof(Position) == 2 * sizeof(float), "Position must be tightly packed.");
+static_assert(sizeof(Velocity) == 2 * sizeof(float), "Velocity must be tightly packed.");
+static_assert(sizeof(Bounds)   == 4 * sizeof(float), "Bounds must be tightly packed.");
+
+// stable IDs so snapshots map columns without a remap
+ECS_COMPONENT_ID(Position, 0);
+ECS_COMPONENT_ID(Velocity, 1);
+ECS_COMPONENT_ID(Bounds,   2);
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "ecs/types.hpp"
 #include "ecs/component.hpp"
+#include "ecs/enable_mask.hpp"
 #include "utils/assert.hpp"
 
 #include <array>
@@ -11,10 +12,25 @@ namespace ECS {
 
 // =============================================================================
 // Archetype
+//
+// Describes the entity row of a set of components and how rows are laid out
+// in a chunk of each size class: a column per component, each starting on a
+// CHUNK_COLUMN_ALIGNMENT boundary, followed by an enable mask per enableable
+// component. New chunks use the current size class,
+// chunks allocated before a class change keep their own layout.
 // =============================================================================
-    
+
+// column layout of one chunk size class
+struct ChunkLayout {
+    ChunkIdx capacity; // entities per chunk, 0 if a row does not fit
+    std::array<ComponentSize, CHUNK_COMPONENT_CAPACITY> offsets; // column offsets in the chunk buffer
+    std::array<ComponentSize, CHUNK_COMPONENT_CAPACITY> enableOffsets; // enable mask offsets, 0 if none
+};
+
 class Archetype {
     friend class ArchetypeManager;
+    friend class ChunkManager;
+    friend class Snapshot;
 
 public:
     Archetype(
@@ -24,17 +40,54 @@ public:
 
     bool hasComponent(ComponentID cID) const;
 
+    static size_t alignColumn(size_t offset);
+
     ArchetypeID getID() const { return id; }
-    ArchetypeMask getMask() const { return mask; }
-    ChunkIdx getCapacity() const { return capacity; }
+    const ArchetypeMask& getMask() const { return mask; }
+    ChunkIdx getCapacity() const { return layouts[size_t(sizeClass)].capacity; }
+    ChunkIdx getCapacity(ChunkSizeClass sizeClass) const { return layouts[size_t(sizeClass)].capacity; }
+    const ChunkLayout& getLayout(ChunkSizeClass sizeClass) const { return layouts[size_t(sizeClass)]; }
+    ChunkIdx getRowSize() const { return rowSize; }
     const std::vector<Component>& getComponents() const { return components; }
 
+    // column of a component in chunks of this archetype (CHUNK_COLUMN_NULL if absent)
+    uint8_t getColumn(ComponentID cID) const { return columns[cID]; }
+
+    // columns of the enableable components
+    const std::vector<uint8_t>& getEnableColumns() const { return enableColumns; }
+
+    // chunk size class of new chunks, chosen by the ChunkManager unless pinned
+    // with a hint (AUTO unpins)
+    ChunkSizeClass getSizeClass() const { return sizeClass; }
+    ChunkSizeClass getSizeHint() const { return pinned ? sizeClass : ChunkSizeClass::AUTO; }
+    void setSizeHint(ChunkSizeClass hint);
+    size_t getChunkBytes() const { return chunkBytes; }
+
+    // neighbor graph access (nullptr until the edge is first traversed)
+    Archetype* getInsertEdge(ComponentID cID) const { return inserts[cID]; }
+    Archetype* getRemoveEdge(ComponentID cID) const { return removes[cID]; }
+
 private:
+    size_t _getColumnsSize(ChunkIdx capacity) const;
+    ChunkLayout _computeLayout(size_t bufferSize) const;
+
 	ArchetypeID id;     // unique archetype identifier
     ArchetypeMask mask; // bitmask where set bits represent components
-    ChunkIdx capacity;  // maximum number of entities in chunk of this archetype
+    ChunkIdx rowSize;   // bytes of one entity row (EntityID included)
+
+    // chunk layouts per size class
+    std::array<ChunkLayout, CHUNK_SIZE_CLASS_COUNT> layouts;
+    ChunkSizeClass baseClass; // smallest class fitting CHUNK_MIN_ROWS rows
+    ChunkSizeClass sizeClass; // class of new chunks
+    bool pinned;              // sizeClass was set with a hint
+    size_t chunkBytes;        // bytes of the live chunks of this archetype
 
     std::vector<Component> components;
+    std::vector<uint8_t> enableColumns;
+
+    // component ID to column lookup table, shared by every chunk (kept out of
+    // the chunk header since it grows with COMPONENT_CAPACITY)
+    std::array<uint8_t, COMPONENT_CAPACITY> columns;
 
     // neighbor graph nodes
     std::array<Archetype*, COMPONENT_CAPACITY> removes;
@@ -50,39 +103,120 @@ Archetype::Archetype(
         ArchetypeMask mask_,
         const std::vector<Component>& components_ ) {
 
-    ASSERT(components.size() < CHUNK_COMPONENT_CAPACITY,
+    ASSERT(components_.size() < CHUNK_COMPONENT_CAPACITY,
         "Archetype cannot contain more than 16 components.");
 
     id = id_;
     mask = mask_;
     components = std::move(components_);
-    capacity = CHUNK_BUFFER_SIZE;
+    removes.fill(nullptr);
+    inserts.fill(nullptr);
+
+    columns.fill(CHUNK_COLUMN_NULL);
+    for (size_t i = 0; i < components.size(); i++) {
+        columns[components[i].getID()] = static_cast<uint8_t>(i);
+        if (components[i].isEnableable())
+            enableColumns.push_back(static_cast<uint8_t>(i));
+    }
 
     // get size of all component data in a single entity of this archetype
     // NOTE: first "component" is always EntityID
-    ChunkIdx eSize = static_cast<ChunkIdx>(sizeof(EntityID));
+    size_t eSize = sizeof(EntityID);
     for (const Component& c : components) {
         eSize += c.getSize();
     }
 
-    ASSERT(eSize < CHUNK_BUFFER_SIZE,
+    ASSERT(eSize < CHUNK_MAX_SIZE - CHUNK_HEADER_SIZE,
         "Archetype component data size exceeds chunk buffer size.");
+    rowSize = static_cast<ChunkIdx>(eSize);
 
-    // set archetype capacity (i.e. num entities in a chunk) based on data size
-    if (eSize > 0) {
-        capacity = CHUNK_BUFFER_SIZE / eSize;
+    for (size_t i = 0; i < CHUNK_SIZE_CLASS_COUNT; i++) {
+        layouts[i] = _computeLayout(getChunkSize(ChunkSizeClass(i)) - CHUNK_HEADER_SIZE);
     }
 
-    // assign component information
-    ComponentSize offset = sizeof(EntityID) * capacity;
-    for (Component& c : components) {
-        c._setOffset(offset);
-        offset += c.getSize() * capacity;
+    ASSERT(layouts[CHUNK_SIZE_CLASS_COUNT - 1].capacity > 0,
+        "Archetype component data size exceeds chunk buffer size.");
+
+    // start in the smallest class that holds a useful run of rows
+    baseClass = ChunkSizeClass(CHUNK_SIZE_CLASS_COUNT - 1);
+    for (size_t i = 0; i < CHUNK_SIZE_CLASS_COUNT; i++) {
+        if (layouts[i].capacity >= CHUNK_MIN_ROWS) {
+            baseClass = ChunkSizeClass(i);
+            break;
+        }
+    }
+    sizeClass = baseClass;
+    pinned = false;
+    chunkBytes = 0;
+}
+
+// pins new chunks to one size class, AUTO returns the choice to the ChunkManager
+void Archetype::setSizeHint(ChunkSizeClass hint) {
+    if (hint == ChunkSizeClass::AUTO) {
+        pinned = false;
+        return;
+    }
+
+    ASSERT(getCapacity(hint) > 0, "Archetype rows do not fit in chunks of this size class.");
+    sizeClass = hint;
+    pinned = true;
+}
+
+size_t Archetype::alignColumn(size_t offset) {
+    return (offset + CHUNK_COLUMN_ALIGNMENT - 1) & ~(CHUNK_COLUMN_ALIGNMENT - 1);
+}
+
+// total bytes of all columns (EntityIDs and enable masks included) for the
+// given capacity
+size_t Archetype::_getColumnsSize(ChunkIdx capacity) const {
+    size_t size = alignColumn(sizeof(EntityID) * capacity);
+    for (const Component& c : components) {
+        size = alignColumn(size + c.getSize() * capacity);
+    }
+    for (size_t i = 0; i < enableColumns.size(); i++) {
+        size = alignColumn(size + sizeof(uint64_t) * getEnableMaskWords(capacity));
+    }
+    return size;
+}
+
+// set capacity (i.e. num entities in a chunk) based on data size, rounded down
+// to a multiple of CHUNK_CAPACITY_ALIGNMENT so that every column spans whole
+// SIMD registers (unless the entities are too large)
+ChunkLayout Archetype::_computeLayout(size_t bufferSize) const {
+    ChunkLayout layout{};
+
+    size_t step = 1;
+    size_t capacity = bufferSize / rowSize;
+    if (capacity >= CHUNK_CAPACITY_ALIGNMENT) {
+        step = CHUNK_CAPACITY_ALIGNMENT;
+        capacity -= capacity % step;
+    }
+
+    // padding columns to their alignment may push the last one past the buffer
+    while (capacity > step && _getColumnsSize(static_cast<ChunkIdx>(capacity)) > bufferSize) {
+        capacity -= step;
+    }
+
+    if (capacity == 0 || _getColumnsSize(static_cast<ChunkIdx>(capacity)) > bufferSize) {
+        return layout;
+    }
+
+    // every column starts on an aligned boundary
+    layout.capacity = static_cast<ChunkIdx>(capacity);
+    size_t offset = alignColumn(sizeof(EntityID) * capacity);
+    for (size_t i = 0; i < components.size(); i++) {
+        layout.offsets[i] = static_cast<ComponentSize>(offset);
+        offset = alignColumn(offset + components[i].getSize() * capacity);
+    }
+    for (uint8_t column : enableColumns) {
+        layout.enableOffsets[column] = static_cast<ComponentSize>(offset);
+        offset = alignColumn(offset + sizeof(uint64_t) * getEnableMaskWords(layout.capacity));
     }
+    return layout;
 }
 
 bool Archetype::hasComponent(ComponentID cID) const { 
-    return (mask & (ArchetypeMask(1) << cID)) != 0;
+    return mask.test(cID);
 }
 
 } // namespace ECS
\ No newline at end of file
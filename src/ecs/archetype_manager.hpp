@@ -3,9 +3,10 @@
 #include "ecs/types.hpp"
 #include "ecs/archetype.hpp"
 #include "ecs/component.hpp"
+#include "ecs/component_manager.hpp"
+#include "ecs/query_manager.hpp"
 #include "utils/assert.hpp"
 
-#include <algorithm> // for std::sort
 #include <deque>
 #include <unordered_map>
 #include <vector>
@@ -19,31 +20,43 @@ namespace ECS {
 
 class ArchetypeManager {
 public:
-    ArchetypeManager(ComponentManager& componentMgr_);
+    ArchetypeManager(ComponentManager& componentMgr_, QueryManager& queryMgr_);
 
     bool hasArchetype(ArchetypeID id) const;
     Archetype& getArchetype(ArchetypeID id);
+    size_t getArchetypeCount() const { return archetypes.size(); }
 
     template<typename... Components>
     ArchetypeID getOrCreateArchetype();
+    ArchetypeID getOrCreateArchetype(ArchetypeMask mask);
+
+    // neighbor graph traversal, edges are created on first use
+    Archetype& getInsertArchetype(Archetype& src, ComponentID cID);
+    Archetype& getRemoveArchetype(Archetype& src, ComponentID cID);
 
     void print();
 
 private:
+    ArchetypeID _createArchetype(ArchetypeMask mask, std::vector<Component>&& components);
+
     ComponentManager& componentMgr;
+    QueryManager& queryMgr;
 
     std::deque<Archetype> archetypes;
     std::unordered_map<ArchetypeMask, ArchetypeID> maskToIDs;
+    std::vector<ArchetypeID> signatures; // signature ID -> archetype (see getSignatureID())
 };
 
 // =============================================================================
 // ArchetypeManager Functions
 // =============================================================================
 
-ArchetypeManager::ArchetypeManager(ComponentManager& componentMgr_)
+ArchetypeManager::ArchetypeManager(ComponentManager& componentMgr_, QueryManager& queryMgr_)
         : componentMgr(componentMgr_),
+          queryMgr(queryMgr_),
           archetypes({}),
-          maskToIDs({}) {
+          maskToIDs({}),
+          signatures({}) {
     getOrCreateArchetype();
 }
 
@@ -58,37 +71,25 @@ Archetype& ArchetypeManager::getArchetype(ArchetypeID id) {
     return archetypes[id];
 }
 
+// resolved through the signature cache after the first call, so the hot path
+// does no allocation and no hashing
 template<typename... Components>
 ArchetypeID ArchetypeManager::getOrCreateArchetype() {
+    size_t sig = getSignatureID<std::remove_cv_t<std::remove_reference_t<Components>>...>();
+    if (sig < signatures.size() && signatures[sig] != ARCHETYPE_ID_NULL) {
+        return signatures[sig];
+    }
 
-    // build a vector of registered components
-    std::vector<Component> components;
-    components.reserve(sizeof...(Components));
-
-    // helper lambda to add one component type
-    auto _addComponent = [&](auto typeTag) {
-        using T = decltype(typeTag);
-        Component& c = componentMgr.getComponent<T>();
-        components.push_back(c);
-    };
-
-    // expand pack
-    (_addComponent(Components{}), ...);
-
-    // sort components by ID
-    std::sort(
-        components.begin(),
-        components.end(),
-        [](const Component& a, const Component& b) {
-            return a.getID() < b.getID();
-        }
-    );
-
-    // build archetype mask
-    ArchetypeMask mask = 0;
-    for (const Component& c : components) {
-        mask |= (ArchetypeMask(1) << c.getID());
+    // first time this pack is seen by this world
+    ArchetypeMask mask = getSignatureMask<std::remove_cv_t<std::remove_reference_t<Components>>...>();
+    if (sig >= signatures.size()) {
+        signatures.resize(sig + 1, ARCHETYPE_ID_NULL);
     }
+    signatures[sig] = getOrCreateArchetype(mask);
+    return signatures[sig];
+}
+
+ArchetypeID ArchetypeManager::getOrCreateArchetype(ArchetypeMask mask) {
 
     // if archetype already exists then return it
     auto it = maskToIDs.find(mask);
@@ -96,25 +97,62 @@ ArchetypeID ArchetypeManager::getOrCreateArchetype() {
         return it->second;
     }
 
-    // otherwise create new archetype
+    // otherwise build the component vector from the mask bits (sorted by ID)
+    std::vector<Component> components;
+    for (ComponentID cID = 0; cID < COMPONENT_CAPACITY; cID++) {
+        if (mask.test(cID))
+            components.push_back(componentMgr.getComponent(cID));
+    }
+
+    return _createArchetype(mask, std::move(components));
+}
+
+Archetype& ArchetypeManager::getInsertArchetype(Archetype& src, ComponentID cID) {
+    ASSERT(!src.hasComponent(cID), "Archetype already has component " << cID << ".");
+    if (src.inserts[cID]) return *src.inserts[cID];
+
+    ArchetypeID dstID = getOrCreateArchetype(src.getMask() | ArchetypeMask::bit(cID));
+    Archetype& dst = archetypes[dstID];
+    src.inserts[cID] = &dst;
+    dst.removes[cID] = &src;
+    return dst;
+}
+
+Archetype& ArchetypeManager::getRemoveArchetype(Archetype& src, ComponentID cID) {
+    ASSERT(src.hasComponent(cID), "Archetype does not have component " << cID << ".");
+    if (src.removes[cID]) return *src.removes[cID];
+
+    ArchetypeID dstID = getOrCreateArchetype(src.getMask() & ~ArchetypeMask::bit(cID));
+    Archetype& dst = archetypes[dstID];
+    src.removes[cID] = &dst;
+    dst.inserts[cID] = &src;
+    return dst;
+}
+
+ArchetypeID ArchetypeManager::_createArchetype(
+        ArchetypeMask mask,
+        std::vector<Component>&& components) {
     ArchetypeID id = static_cast<ArchetypeID>(archetypes.size());
     archetypes.emplace_back(id, mask, std::move(components));
     maskToIDs.insert({mask, id});
+    queryMgr.onArchetypeCreated(archetypes.back());
     return id;
 }
 
 void ArchetypeManager::print() {
     std::cout << "archetypes:" << std::endl;
     for (const Archetype& a : archetypes) {
+        const ChunkLayout& layout = a.getLayout(a.getSizeClass());
         std::cout << "  - id: "           << a.getID()          << std::endl;
         std::cout << "    mask: "         << a.getMask()        << std::endl;
+        std::cout << "    chunkSize: "    << getChunkSize(a.getSizeClass()) << std::endl;
         std::cout << "    capacity: "     << a.getCapacity()    << std::endl;
         std::cout << "    components: "                         << std::endl;
         std::cout << "    - id: <EntityIDs>"                    << std::endl;
         std::cout << "      offset: "     << 0                  << std::endl;
-        for (const Component& c : a.getComponents()) {
-            std::cout << "    - id: "     << (int)c.getID()     << std::endl;
-            std::cout << "      offset: " <<      c.getOffset() << std::endl;
+        for (size_t i = 0; i < a.getComponents().size(); i++) {
+            std::cout << "    - id: "     << (int)a.getComponents()[i].getID() << std::endl;
+            std::cout << "      offset: " <<      layout.offsets[i]            << std::endl;
         }
     }
 }
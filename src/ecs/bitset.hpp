@@ -0,0 +1,207 @@
+#pragma once
+
+#include <cstddef> // for size_t
+#include <cstdint>
+#include <functional> // for std::hash
+#include <ostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define ECS_BITSET_SSE2 1
+#endif
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define ECS_BITSET_AVX2 1
+#endif
+
+namespace ECS {
+
+// =============================================================================
+// Bitset
+//
+// Fixed width bit mask stored as 64 bit words, e.g. one bit per component in
+// an ArchetypeMask. Unlike std::bitset the layout is known (snapshots store it
+// as is) and the subset/overlap tests used to match queries against
+// archetypes take one SSE2 AND/compare per 128 bits, or one AVX2 test per 256
+// bits when compiled with GAME_ENABLE_AVX2.
+// =============================================================================
+
+template <size_t Bits>
+class Bitset {
+public:
+    static_assert(Bits > 0 && Bits % 64 == 0, "Bitset width must be a multiple of 64 bits.");
+    static constexpr size_t WORDS = Bits / 64;
+
+    constexpr Bitset() : words{} {}
+
+    // bitset with only bit i set
+    static constexpr Bitset bit(size_t i);
+
+    constexpr bool test(size_t i) const { return (words[i / 64] >> (i % 64)) & 1; }
+    constexpr void set(size_t i)   { words[i / 64] |=  (uint64_t(1) << (i % 64)); }
+    constexpr void reset(size_t i) { words[i / 64] &= ~(uint64_t(1) << (i % 64)); }
+
+    bool any() const;
+    bool none() const { return !any(); }
+    size_t count() const;
+
+    bool contains(const Bitset& other) const;   // every bit of other is set
+    bool intersects(const Bitset& other) const; // some bit of other is set
+
+    uint64_t getWord(size_t i) const { return words[i]; }
+    size_t hash() const;
+
+    constexpr Bitset& operator|=(const Bitset& other);
+    constexpr Bitset& operator&=(const Bitset& other);
+    constexpr Bitset operator|(const Bitset& other) const { Bitset r = *this; return r |= other; }
+    constexpr Bitset operator&(const Bitset& other) const { Bitset r = *this; return r &= other; }
+    constexpr Bitset operator~() const;
+    bool operator==(const Bitset& other) const;
+    bool operator!=(const Bitset& other) const { return !(*this == other); }
+
+private:
+    uint64_t words[WORDS];
+};
+
+// =============================================================================
+// Bitset Functions
+// =============================================================================
+
+template <size_t Bits>
+constexpr Bitset<Bits> Bitset<Bits>::bit(size_t i) {
+    Bitset b;
+    b.set(i);
+    return b;
+}
+
+template <size_t Bits>
+bool Bitset<Bits>::any() const {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < WORDS; i++) bits |= words[i];
+    return bits != 0;
+}
+
+template <size_t Bits>
+size_t Bitset<Bits>::count() const {
+    size_t n = 0;
+    for (size_t i = 0; i < WORDS; i++) {
+        for (uint64_t w = words[i]; w; w &= w - 1) n++;
+    }
+    return n;
+}
+
+template <size_t Bits>
+bool Bitset<Bits>::contains(const Bitset& other) const {
+#if defined(ECS_BITSET_AVX2)
+    if constexpr (WORDS % 4 == 0) {
+        // testc: (~this & other) == 0
+        for (size_t i = 0; i < WORDS; i += 4) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(other.words + i));
+            if (!_mm256_testc_si256(a, b)) return false;
+        }
+        return true;
+    }
+#endif
+#if defined(ECS_BITSET_SSE2)
+    if constexpr (WORDS % 2 == 0) {
+        __m128i missing = _mm_setzero_si128();
+        for (size_t i = 0; i < WORDS; i += 2) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(other.words + i));
+            missing = _mm_or_si128(missing, _mm_andnot_si128(a, b));
+        }
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(missing, _mm_setzero_si128())) == 0xFFFF;
+    }
+#endif
+    uint64_t missing = 0;
+    for (size_t i = 0; i < WORDS; i++) missing |= other.words[i] & ~words[i];
+    return missing == 0;
+}
+
+template <size_t Bits>
+bool Bitset<Bits>::intersects(const Bitset& other) const {
+#if defined(ECS_BITSET_AVX2)
+    if constexpr (WORDS % 4 == 0) {
+        // testz: (this & other) == 0
+        for (size_t i = 0; i < WORDS; i += 4) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(other.words + i));
+            if (!_mm256_testz_si256(a, b)) return true;
+        }
+        return false;
+    }
+#endif
+#if defined(ECS_BITSET_SSE2)
+    if constexpr (WORDS % 2 == 0) {
+        __m128i common = _mm_setzero_si128();
+        for (size_t i = 0; i < WORDS; i += 2) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(other.words + i));
+            common = _mm_or_si128(common, _mm_and_si128(a, b));
+        }
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(common, _mm_setzero_si128())) != 0xFFFF;
+    }
+#endif
+    uint64_t common = 0;
+    for (size_t i = 0; i < WORDS; i++) common |= words[i] & other.words[i];
+    return common != 0;
+}
+
+// 64 bit multiply-xorshift mix of every word
+template <size_t Bits>
+size_t Bitset<Bits>::hash() const {
+    uint64_t h = 0x9e3779b97f4a7c15ULL;
+    for (size_t i = 0; i < WORDS; i++) {
+        h ^= words[i];
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+    }
+    return static_cast<size_t>(h);
+}
+
+template <size_t Bits>
+constexpr Bitset<Bits>& Bitset<Bits>::operator|=(const Bitset& other) {
+    for (size_t i = 0; i < WORDS; i++) words[i] |= other.words[i];
+    return *this;
+}
+
+template <size_t Bits>
+constexpr Bitset<Bits>& Bitset<Bits>::operator&=(const Bitset& other) {
+    for (size_t i = 0; i < WORDS; i++) words[i] &= other.words[i];
+    return *this;
+}
+
+template <size_t Bits>
+constexpr Bitset<Bits> Bitset<Bits>::operator~() const {
+    Bitset r;
+    for (size_t i = 0; i < WORDS; i++) r.words[i] = ~words[i];
+    return r;
+}
+
+template <size_t Bits>
+bool Bitset<Bits>::operator==(const Bitset& other) const {
+    uint64_t diff = 0;
+    for (size_t i = 0; i < WORDS; i++) diff |= words[i] ^ other.words[i];
+    return diff == 0;
+}
+
+// hex, most significant word first
+template <size_t Bits>
+std::ostream& operator<<(std::ostream& os, const Bitset<Bits>& b) {
+    static const char* digits = "0123456789abcdef";
+    char text[Bits / 4 + 3] = {'0', 'x'};
+    for (size_t i = 0; i < Bits / 4; i++) {
+        size_t nibble = Bits / 4 - 1 - i;
+        text[2 + i] = digits[(b.getWord(nibble / 16) >> ((nibble % 16) * 4)) & 0xF];
+    }
+    text[Bits / 4 + 2] = '\0';
+    return os << text;
+}
+
+} // namespace ECS
+
+template <size_t Bits>
+struct std::hash<ECS::Bitset<Bits>> {
+    size_t operator()(const ECS::Bitset<Bits>& b) const { return b.hash(); }
+};
\ No newline at end of file
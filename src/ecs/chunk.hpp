@@ -3,11 +3,16 @@
 #include "ecs/types.hpp"
 #include "ecs/archetype.hpp"
 #include "ecs/component.hpp"
+#include "ecs/component_manager.hpp"
+#include "ecs/enable_mask.hpp"
 #include "ecs/entity.hpp"
 #include "ecs/entity_manager.hpp"
+#include "ecs/shared_component_manager.hpp"
 #include "utils/assert.hpp"
 
+#include <algorithm> // for std::fill_n
 #include <array>
+#include <atomic>
 #include <cstddef> // for std::byte
 #include <cstdint>
 #include <cstring> // for std::memcpy
@@ -21,25 +26,31 @@ namespace ECS {
 // A Chunk is a flat contiguous block of memory storing entity component data.
 // It is designed for efficient memory access and cache locality.
 //
-// { h_0, h_1, ..., h_N,   header 256 bytes
+// { h_0, h_1, ..., h_N,   header 320 bytes
 //   e_0, e_1, ..., e_X,   chunk.data<EntityIDs>()
 //   cA0, cA1, ..., cAX,   chunk.data<ComponentA>()
 //   cB0, cB1, ..., cBX,   chunk.data<ComponentB>()
 //   ..., ..., ..., ...,   ...
-//   cY0, cY1, ..., cYX, } chunk.data<ComponentY>
+//   cY0, cY1, ..., cYX,   chunk.data<ComponentY>
+//   bits of cA,           chunk.getEnableMask<ComponentA>() (if enableable)
+//   ..., }
 //
+// The Chunk object is the header, the buffer follows it in the same block up
+// to the size of its size class (4KB, 16KB or 64KB). The class of a block is
+// fixed, so recycled blocks only ever serve archetypes of that class.
 // =============================================================================
 
-class Chunk {
+class alignas(CHUNK_COLUMN_ALIGNMENT) Chunk {
     friend class ChunkManager;
     friend class ChunkList;
 
 public:
-    Chunk() { _clear(); }
+    Chunk(ChunkSizeClass sizeClass) : sizeClass(sizeClass) { _clear(false); }
 
     // queries
     template <typename T>
     bool hasComponent() const;
+    bool hasComponent(ComponentID cID) const;
     bool isFull()  const { return count >= capacity; }
     bool isEmpty() const { return count == 0; }
 
@@ -48,27 +59,65 @@ public:
     GroupID  getGroupID()  const { return groupID;  }
     ChunkIdx getCount()    const { return count;    }
     ChunkIdx getCapacity() const { return capacity; }
+    uint32_t getVersion()  const { return version;  }
+    ChunkSizeClass getSizeClass() const { return sizeClass; }
+    size_t getSize() const { return getChunkSize(sizeClass); }
+    uint32_t getComponentVersion(ComponentID cID) const;
+    uint32_t getLatestVersion() const;
 
     Archetype* getArchetype() const { return archetype; }
+    const SharedSet& getSharedSet() const { return *sharedSet; }
+    SharedSetID getSharedSetID() const { return sharedSet->id; }
+    Chunk* getNextChunk() const { return nextChunk; }
 
     // buffer access (NOTE: unsafe! can be indexed out of bounds...)
+    // NOTE: mutable data<T>() marks the column as written at the world version
     const EntityID* getEntityIDs() const;
     template <typename T>
     T*       data();
     template <typename T>
     const T* data() const;
 
+    // shared component value of every entity in the chunk, nullptr if absent
+    template <typename S>
+    const S* getShared() const;
+
+    // enable bits of enableable components, a toggle is one bit write that
+    // bumps the chunk version (so delta snapshots keep it) but is not a
+    // column write for Changed<Ts...>
+    template <typename T>
+    bool isEnabled(ChunkIdx index) const;
+    bool isEnabled(ComponentID cID, ChunkIdx index) const;
+    template <typename T>
+    void setEnabled(ChunkIdx index, bool enabled);
+    void setEnabled(ComponentID cID, ChunkIdx index, bool enabled);
+    template <typename T>
+    const uint64_t* getEnableMask() const;
+    const uint64_t* getEnableMask(ComponentID cID) const; // nullptr if not enableable
+
 private:
-    void _clear();
-    void _initialize(ChunkID chunkID, GroupID groupID, Archetype* archetype);
+    void _clear(bool zeroBuffer);
+    void _initialize(ChunkID chunkID, GroupID groupID, Archetype* archetype, const SharedSet* sharedSet, const std::atomic<uint32_t>* worldVersion);
+    void _bind(ChunkID chunkID, GroupID groupID, Archetype* archetype, const SharedSet* sharedSet, const std::atomic<uint32_t>* worldVersion);
+    void _adopt(ChunkID chunkID, GroupID groupID, Archetype* archetype, const SharedSet* sharedSet, const std::atomic<uint32_t>* worldVersion, ChunkSizeClass sizeClass, ChunkIdx count);
     EntityID* _getEntityIDs();
+    std::byte* _getBuffer() { return reinterpret_cast<std::byte*>(this) + CHUNK_HEADER_SIZE; }
+    const std::byte* _getBuffer() const { return reinterpret_cast<const std::byte*>(this) + CHUNK_HEADER_SIZE; }
+    void _markStructuralChange();
+    uint64_t* _getEnableMask(uint8_t column);
+    const uint64_t* _getEnableMask(uint8_t column) const;
+    void _enableRows(ChunkIdx beg, ChunkIdx n);
 
     // handle entity data
     template<typename... Components>
     void _insertEntity(EntityID eID, EntityManager& eMgr, Components&&... eData);
+    template<typename... Components>
+    void _insertEntities(const EntityID* eIDs, ChunkIdx n, EntityManager& eMgr, const Components&... prototypes);
+    template<typename... Components>
+    void _insertEntityColumns(const EntityID* eIDs, ChunkIdx n, EntityManager& eMgr, const Components*... columns);
     void _removeEntity(EntityID eID, EntityManager& eMgr);
-    // void _moveEntityTo(Chunk* other, Entity& entity);
-    // void _moveEntityFrom(Chunk* other, Entity& entity);
+    void _removeRow(ChunkIdx index, EntityManager& eMgr);
+    void _moveEntityFrom(Chunk& other, EntityID eID, EntityManager& eMgr);
 
     // handle entity data helpers
     inline void _setEntityID(ChunkIdx index, EntityID eID);
@@ -76,6 +125,7 @@ private:
     void _setEntityComponentData(ChunkIdx index, T&& first, Rest&&... rest);
     template<typename T>
     void _setSingleEntityComponentData(ChunkIdx index, T&& data);
+    void _setComponentData(ChunkIdx index, ComponentID cID, const void* data);
 
     // header (metadata)
     ChunkID chunkID;      // 4B unique identifier
@@ -86,52 +136,157 @@ private:
     Chunk* nextChunkOpen; // 8B list node to next chunk with open entity slots
     ChunkIdx count;       // 2B num entities in this chunk
     ChunkIdx capacity;    // 2B max entities in this chunk
-    uint32_t version;     // 4B structural change version
+    uint32_t version;     // 4B structural change or enable toggle version
+    ChunkSizeClass sizeClass; // 1B size class of the block, kept when cleared
     Archetype* archetype; // 8B pointer to parent archetype
+    const std::atomic<uint32_t>* worldVersion; // 8B pointer to the world version counter
+    const SharedSet* sharedSet;   // 8B shared component values of this chunk
 
-    // header (component address lookup tables)
-    std::array<ComponentID, COMPONENT_CAPACITY> toIdx;   // 64B
+    // header (column address lookup table, see Archetype::getColumn)
     std::array<void*, CHUNK_COMPONENT_CAPACITY> bufPtrs; // 128B
 
-    // entity component data buffer
-    alignas(64) std::array<std::byte, CHUNK_BUFFER_SIZE> buffer; // 16KB - 256B
+    // header (world version at which each column was last written)
+    std::array<uint32_t, CHUNK_COMPONENT_CAPACITY> versions; // 64B
+
+    // header (enable mask buffer offset per column, 0 if not enableable)
+    std::array<ComponentSize, CHUNK_COMPONENT_CAPACITY> enableOffsets; // 32B
+
+    // entity component data buffer follows (size class - 320B)
 };
 
+static_assert(sizeof(Chunk) == CHUNK_HEADER_SIZE, "Chunk header exceeds CHUNK_HEADER_SIZE.");
+
 // =============================================================================
 // Chunk Functions
 // =============================================================================
 
 template <typename T>
 bool Chunk::hasComponent() const {
-    ComponentID cID = getComponentID<T>();
-    if (cID < COMPONENT_CAPACITY)
-        return bufPtrs[toIdx[cID]] != nullptr;
+    return hasComponent(getComponentID<T>());
+}
+
+bool Chunk::hasComponent(ComponentID cID) const {
+    if (archetype && cID < COMPONENT_CAPACITY)
+        return archetype->getColumn(cID) != CHUNK_COLUMN_NULL;
     return false;
 }
 
 EntityID* Chunk::_getEntityIDs() {
-    return reinterpret_cast<EntityID*>(buffer.data());
+    return reinterpret_cast<EntityID*>(_getBuffer());
 }
 
 const EntityID* Chunk::getEntityIDs() const {
-    return reinterpret_cast<const EntityID*>(buffer.data());
+    return reinterpret_cast<const EntityID*>(_getBuffer());
 }
 
 template <typename T>
 T* Chunk::data() {
     ASSERT(hasComponent<T>(), "Component is not in Chunk.");
     ComponentID cID = getComponentID<T>();
-    return reinterpret_cast<T*>(bufPtrs[toIdx[cID]]);
+    if constexpr (!std::is_const_v<T>) {
+        versions[archetype->getColumn(cID)] = worldVersion->load(std::memory_order_relaxed);
+    }
+    return reinterpret_cast<T*>(bufPtrs[archetype->getColumn(cID)]);
 }
 
 template <typename T>
 const T* Chunk::data() const {
     ASSERT(hasComponent<T>(), "Component is not in Chunk.");
     ComponentID cID = getComponentID<T>();
-    return reinterpret_cast<const T*>(bufPtrs[toIdx[cID]]);
+    return reinterpret_cast<const T*>(bufPtrs[archetype->getColumn(cID)]);
+}
+
+template <typename S>
+const S* Chunk::getShared() const {
+    return static_cast<const S*>(sharedSet->get(getComponentID<S>()));
+}
+
+uint32_t Chunk::getComponentVersion(ComponentID cID) const {
+    ASSERT(hasComponent(cID), "Component is not in Chunk.");
+    return versions[archetype->getColumn(cID)];
+}
+
+// world version of the latest structural change or column write
+uint32_t Chunk::getLatestVersion() const {
+    uint32_t latest = version;
+    for (uint32_t v : versions) {
+        if (v > latest) latest = v;
+    }
+    return latest;
+}
+
+// rows were inserted, removed or reordered so every column counts as written
+void Chunk::_markStructuralChange() {
+    version = worldVersion->load(std::memory_order_relaxed);
+    versions.fill(version);
+}
+
+// =============================================================================
+// Chunk Enable Functions
+// =============================================================================
+
+template <typename T>
+bool Chunk::isEnabled(ChunkIdx index) const {
+    return isEnabled(getComponentID<T>(), index);
+}
+
+// true for components that are not enableable
+bool Chunk::isEnabled(ComponentID cID, ChunkIdx index) const {
+    ASSERT(hasComponent(cID), "Component is not in Chunk.");
+    ASSERT(index < count, "Index out of bounds.");
+    const uint64_t* bits = getEnableMask(cID);
+    return !bits || ((bits[index / 64] >> (index % 64)) & 1);
+}
+
+template <typename T>
+void Chunk::setEnabled(ChunkIdx index, bool enabled) {
+    setEnabled(getComponentID<T>(), index, enabled);
+}
+
+void Chunk::setEnabled(ComponentID cID, ChunkIdx index, bool enabled) {
+    ASSERT(hasComponent(cID), "Component is not in Chunk.");
+    ASSERT(index < count, "Index out of bounds.");
+    uint8_t column = archetype->getColumn(cID);
+    ASSERT(enableOffsets[column] != 0, "Component is not enableable.");
+
+    uint64_t& word = _getEnableMask(column)[index / 64];
+    uint64_t bit = uint64_t(1) << (index % 64);
+    word = enabled ? (word | bit) : (word & ~bit);
+    version = worldVersion->load(std::memory_order_relaxed);
+}
+
+template <typename T>
+const uint64_t* Chunk::getEnableMask() const {
+    return getEnableMask(getComponentID<T>());
+}
+
+const uint64_t* Chunk::getEnableMask(ComponentID cID) const {
+    if (!hasComponent(cID)) return nullptr;
+    uint8_t column = archetype->getColumn(cID);
+    return enableOffsets[column] ? _getEnableMask(column) : nullptr;
+}
+
+uint64_t* Chunk::_getEnableMask(uint8_t column) {
+    return reinterpret_cast<uint64_t*>(_getBuffer() + enableOffsets[column]);
+}
+
+const uint64_t* Chunk::_getEnableMask(uint8_t column) const {
+    return reinterpret_cast<const uint64_t*>(_getBuffer() + enableOffsets[column]);
+}
+
+// new rows start with every enableable component enabled
+void Chunk::_enableRows(ChunkIdx beg, ChunkIdx n) {
+    for (uint8_t column : archetype->getEnableColumns()) {
+        uint64_t* bits = _getEnableMask(column);
+        for (size_t i = beg; i < size_t(beg) + n; i++) {
+            bits[i / 64] |= uint64_t(1) << (i % 64);
+        }
+    }
 }
 
-void Chunk::_clear() {
+// resets the header, the buffer is only zeroed on request since every row is
+// fully written before it becomes visible
+void Chunk::_clear(bool zeroBuffer) {
     chunkID = CHUNK_ID_NULL;
     groupID = GROUP_ID_NULL;
     prevChunk = nullptr;
@@ -142,28 +297,76 @@ void Chunk::_clear() {
     capacity = 0;
     version  = 0;
     archetype  = nullptr;
-    toIdx.fill(COMPONENT_ID_NULL);
+    worldVersion = nullptr;
+    sharedSet = nullptr;
     bufPtrs.fill(nullptr);
-    buffer.fill(std::byte(0));
+    versions.fill(0);
+    enableOffsets.fill(0);
+    if (zeroBuffer) std::memset(_getBuffer(), 0, getSize() - CHUNK_HEADER_SIZE);
+}
+
+// binds a fresh chunk, its enable masks start clear (no rows)
+void Chunk::_initialize(
+        ChunkID chunkID,
+        GroupID groupID,
+        Archetype* archetype,
+        const SharedSet* sharedSet,
+        const std::atomic<uint32_t>* worldVersion) {
+    _bind(chunkID, groupID, archetype, sharedSet, worldVersion);
+
+    for (uint8_t column : archetype->getEnableColumns()) {
+        std::memset(_getEnableMask(column), 0, sizeof(uint64_t) * getEnableMaskWords(capacity));
+    }
 }
 
-void Chunk::_initialize(ChunkID chunkID, GroupID groupID, Archetype* archetype) {
+void Chunk::_bind(
+        ChunkID chunkID,
+        GroupID groupID,
+        Archetype* archetype,
+        const SharedSet* sharedSet,
+        const std::atomic<uint32_t>* worldVersion) {
     this->chunkID = chunkID;
     this->groupID = groupID;
     this->archetype = archetype;
-    capacity = archetype->getCapacity();
-
-    // initialize component address lookup tables
-    const std::vector<Component> components = archetype->getComponents();
-    for (size_t i = 0; i < components.size(); i++) {
-        const Component& c = components[i];
-        toIdx[c.getID()] = i;
-        // TODO: need to check if archetype does this
-        // ASSERT(offset + sizeof(T) * count <= BUFFER_SIZE, "Component array exceeds chunk buffer.");
-        bufPtrs[i] = static_cast<void*>(buffer.data() + c.getOffset());
+    this->sharedSet = sharedSet;
+    this->worldVersion = worldVersion;
+
+    // the layout is fixed for the life of the chunk, even if the archetype
+    // later moves new chunks to another size class
+    const ChunkLayout& layout = archetype->getLayout(sizeClass);
+    ASSERT(layout.capacity > 0, "Archetype rows do not fit in chunks of this size class.");
+    capacity = layout.capacity;
+
+    // initialize column address lookup table
+    for (size_t i = 0; i < archetype->getComponents().size(); i++) {
+        bufPtrs[i] = static_cast<void*>(_getBuffer() + layout.offsets[i]);
+        enableOffsets[i] = layout.enableOffsets[i];
     }
 }
 
+// takes over a chunk image (e.g. loaded from a snapshot) whose buffer, enable
+// masks and versions are valid but whose header pointers are stale
+void Chunk::_adopt(
+        ChunkID chunkID,
+        GroupID groupID,
+        Archetype* archetype,
+        const SharedSet* sharedSet,
+        const std::atomic<uint32_t>* worldVersion,
+        ChunkSizeClass sizeClass,
+        ChunkIdx count) {
+    ASSERT(count <= archetype->getCapacity(sizeClass), "Chunk image count exceeds archetype capacity.");
+    this->sizeClass = sizeClass;
+    uint32_t savedVersion = version;
+    std::array<uint32_t, CHUNK_COMPONENT_CAPACITY> savedVersions = versions;
+
+    _clear(false);
+    _bind(chunkID, groupID, archetype, sharedSet, worldVersion);
+
+    this->count = count;
+    version  = savedVersion;
+    versions = savedVersions;
+}
+
 // =============================================================================
 // Chunk Entity Functions
 // =============================================================================
@@ -172,12 +375,56 @@ template<typename... Components>
 void Chunk::_insertEntity(EntityID eID, EntityManager& eMgr, Components&&... eData) {
     ASSERT(!isFull(), "Cannot insert entity into full chunk.");
 
-    Entity& entity = eMgr.getEntity(eID);
     _setEntityID(count, eID);
-    _setEntityComponentData(count, std::forward<Components>(eData)...);
+    if constexpr (sizeof...(Components) > 0) {
+        _setEntityComponentData(count, std::forward<Components>(eData)...);
+    }
     eMgr.setEntity(eID, chunkID, count);
+    _enableRows(count, 1);
     count++;
-    // version++;
+    _markStructuralChange();
+}
+
+// appends n entities, every row a copy of the prototypes
+template<typename... Components>
+void Chunk::_insertEntities(const EntityID* eIDs, ChunkIdx n, EntityManager& eMgr, const Components&... prototypes) {
+    ASSERT(count + n <= capacity, "Cannot insert entities past chunk capacity.");
+
+    std::memcpy(_getEntityIDs() + count, eIDs, sizeof(EntityID) * n);
+
+    auto _fillColumn = [&](const auto& prototype) {
+        using T = std::remove_cv_t<std::remove_reference_t<decltype(prototype)>>;
+        if constexpr (!IsTagType<T>) {
+            std::fill_n(data<T>() + count, n, prototype);
+        }
+    };
+    (_fillColumn(prototypes), ...);
+
+    eMgr.setEntities(eIDs, n, chunkID, count);
+    _enableRows(count, n);
+    count += n;
+    _markStructuralChange();
+}
+
+// appends n entities, copying each column from a contiguous source array
+template<typename... Components>
+void Chunk::_insertEntityColumns(const EntityID* eIDs, ChunkIdx n, EntityManager& eMgr, const Components*... columns) {
+    ASSERT(count + n <= capacity, "Cannot insert entities past chunk capacity.");
+
+    std::memcpy(_getEntityIDs() + count, eIDs, sizeof(EntityID) * n);
+
+    auto _copyColumn = [&](const auto* column) {
+        using T = std::remove_cv_t<std::remove_pointer_t<decltype(column)>>;
+        if constexpr (!IsTagType<T>) {
+            std::memcpy(data<T>() + count, column, sizeof(T) * n);
+        }
+    };
+    (_copyColumn(columns), ...);
+
+    eMgr.setEntities(eIDs, n, chunkID, count);
+    _enableRows(count, n);
+    count += n;
+    _markStructuralChange();
 }
 
 void Chunk::_removeEntity(EntityID eID, EntityManager& eMgr) {
@@ -186,21 +433,28 @@ void Chunk::_removeEntity(EntityID eID, EntityManager& eMgr) {
 
     ASSERT(_getEntityIDs()[remvIdx] == eID, "Entity ID mismatch at chunk location.");
 
+    _removeRow(remvIdx, eMgr);
+    eMgr.freeEntity(eID);
+}
+
+// swap-removes a row, the entity record of the removed row is left untouched
+void Chunk::_removeRow(ChunkIdx remvIdx, EntityManager& eMgr) {
+    ASSERT(remvIdx < count, "Index out of bounds.");
+
     ChunkIdx lastIdx = count - 1;
 
     if (remvIdx != lastIdx) {
         EntityID lastID = _getEntityIDs()[lastIdx];
-        Entity& lastEntity = eMgr.getEntity(lastID);
 
         _setEntityID(remvIdx, lastID);
 
         for (const Component& component : archetype->getComponents()) {
-            if (component.isTag()) continue;
+            if (!component.hasColumn()) continue;
 
             ComponentID cID = component.getID();
             ComponentSize cSize = component.getSize();
 
-            std::byte* arr = static_cast<std::byte*>(bufPtrs[toIdx[cID]]);
+            std::byte* arr = static_cast<std::byte*>(bufPtrs[archetype->getColumn(cID)]);
             std::byte* dst = arr + (cSize * remvIdx);
             std::byte* src = arr + (cSize * lastIdx);
 
@@ -210,10 +464,60 @@ void Chunk::_removeEntity(EntityID eID, EntityManager& eMgr) {
         eMgr.setEntity(lastID, chunkID, remvIdx);
     }
 
-    eMgr.freeEntity(eID);
+    // the last row's bit takes the removed row's place, bits past count stay clear
+    for (uint8_t column : archetype->getEnableColumns()) {
+        uint64_t* bits = _getEnableMask(column);
+        bool last = (bits[lastIdx / 64] >> (lastIdx % 64)) & 1;
+        bits[lastIdx / 64] &= ~(uint64_t(1) << (lastIdx % 64));
+        if (remvIdx != lastIdx) {
+            uint64_t bit = uint64_t(1) << (remvIdx % 64);
+            bits[remvIdx / 64] = last ? (bits[remvIdx / 64] | bit) : (bits[remvIdx / 64] & ~bit);
+        }
+    }
 
     count--;
-    // version++;
+    _markStructuralChange();
+}
+
+// appends an entity row from another chunk, copying only the columns both
+// chunks share, then swap-removes the row from the other chunk
+void Chunk::_moveEntityFrom(Chunk& other, EntityID eID, EntityManager& eMgr) {
+    ASSERT(!isFull(), "Cannot move entity into full chunk.");
+    ASSERT(&other != this, "Cannot move entity into the chunk it is already in.");
+
+    ChunkIdx srcIdx = eMgr.getEntity(eID).getChunkIdx();
+    ChunkIdx dstIdx = count;
+
+    ASSERT(other._getEntityIDs()[srcIdx] == eID, "Entity ID mismatch at chunk location.");
+
+    _setEntityID(dstIdx, eID);
+
+    for (const Component& component : archetype->getComponents()) {
+        if (!component.hasColumn()) continue;
+
+        ComponentID cID = component.getID();
+        if (!other.hasComponent(cID)) continue;
+
+        ComponentSize cSize = component.getSize();
+        std::byte* dst = static_cast<std::byte*>(bufPtrs[archetype->getColumn(cID)]) + (cSize * dstIdx);
+        std::byte* src = static_cast<std::byte*>(other.bufPtrs[other.archetype->getColumn(cID)]) + (cSize * srcIdx);
+
+        std::memcpy(dst, src, cSize);
+    }
+
+    count++;
+    _markStructuralChange();
+
+    // enable bits follow the row, components new to the entity start enabled
+    _enableRows(dstIdx, 1);
+    for (uint8_t column : archetype->getEnableColumns()) {
+        ComponentID cID = archetype->getComponents()[column].getID();
+        if (other.hasComponent(cID) && !other.isEnabled(cID, srcIdx))
+            setEnabled(cID, dstIdx, false);
+    }
+
+    other._removeRow(srcIdx, eMgr);
+    eMgr.setEntity(eID, chunkID, dstIdx);
 }
 
 inline void Chunk::_setEntityID(ChunkIdx index, EntityID eID) {
@@ -234,9 +538,23 @@ void Chunk::_setEntityComponentData(ChunkIdx index, T&& first, Rest&&... rest) {
 
 template<typename T>
 void Chunk::_setSingleEntityComponentData(ChunkIdx index, T&& componentData) {
-    if constexpr (IsTagType<T>) return; // ignore tags
-    ASSERT(hasComponent<T>(), "Component is not in Chunk.");
-    data<T>()[index] = std::forward<T>(componentData);
+    using C = std::remove_cv_t<std::remove_reference_t<T>>;
+    if constexpr (IsTagType<C>) return; // ignore tags
+    ASSERT(hasComponent<C>(), "Component is not in Chunk.");
+    data<C>()[index] = std::forward<T>(componentData);
+}
+
+void Chunk::_setComponentData(ChunkIdx index, ComponentID cID, const void* componentData) {
+    ASSERT(hasComponent(cID), "Component is not in Chunk.");
+    ASSERT(index < count, "Index out of bounds.");
+
+    const Component& component = archetype->getComponents()[archetype->getColumn(cID)];
+    if (!component.hasColumn()) return; // ignore tags and shared components
+
+    ComponentSize cSize = component.getSize();
+    std::byte* dst = static_cast<std::byte*>(bufPtrs[archetype->getColumn(cID)]) + (cSize * index);
+    std::memcpy(dst, componentData, cSize);
+    versions[archetype->getColumn(cID)] = worldVersion->load(std::memory_order_relaxed);
 }
 
 } // namespace ECS
\ No newline at end of file
@@ -0,0 +1,206 @@
+#pragma once
+
+#include "ecs/types.hpp"
+#include "utils/assert.hpp"
+
+#include <array>
+#include <cstddef> // for std::byte
+#include <cstdint> // for uintptr_t
+#include <cstring> // for std::memset
+#include <new>     // for std::align_val_t
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+    #include <sys/mman.h>
+#elif defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#endif
+
+namespace ECS {
+
+// =============================================================================
+// ChunkAllocator
+//
+// Hands out chunk blocks of each size class (4KB, 16KB, 64KB) carved from large
+// slabs shared by all classes. Blocks are aligned to their own size within the
+// slab, never move once handed out, freed blocks are recycled LIFO per class
+// without touching the heap, and slabs are only returned to the OS when the
+// allocator is destroyed. Slab bytes skipped to align a block, and the tail of
+// a slab too short for a block, are carved into smaller blocks instead of
+// being wasted.
+//
+// On Linux slabs are mmap'd, aligned to 2MB and madvise'd for transparent huge
+// pages (when enabled) so the chunks of a slab share a handful of TLB entries.
+// Fresh slab memory is zeroed by the OS, recycled blocks are not.
+//
+// The allocator also takes ownership of regions it did not allocate (e.g. a
+// mapped snapshot file whose chunk images were adopted by the ChunkManager)
+// and releases them with the slabs.
+// =============================================================================
+
+class ChunkAllocator {
+public:
+    static constexpr size_t SLAB_SIZE      = 2 * 1024 * 1024; // 2MB (one huge page)
+    static constexpr size_t SLAB_ALIGNMENT = SLAB_SIZE;
+
+    ChunkAllocator(bool useHugePages = true);
+    ~ChunkAllocator();
+
+    ChunkAllocator(const ChunkAllocator&) = delete;
+    ChunkAllocator& operator=(const ChunkAllocator&) = delete;
+
+    void* allocate(ChunkSizeClass sizeClass);
+    void  deallocate(void* block, ChunkSizeClass sizeClass);
+
+    // region release, MAPPED regions are munmap'd, HEAP regions were
+    // allocated with operator new aligned to CHUNK_MIN_SIZE
+    enum class RegionType : uint8_t { MAPPED, HEAP };
+    void adoptRegion(void* base, size_t size, RegionType type);
+
+    size_t getSlabCount()      const { return slabs.size(); }
+    size_t getFreeBlockCount(ChunkSizeClass sizeClass) const { return freeBlocks[size_t(sizeClass)].size(); }
+    size_t getFreeSlabBytes()  const { return SLAB_SIZE - slabUsed; }
+    size_t getReservedBytes()  const { return slabs.size() * SLAB_SIZE; }
+
+private:
+    std::byte* _allocateSlab();
+    void       _freeSlab(std::byte* slab);
+    void       _carve(size_t end);
+
+    bool useHugePages;
+    std::vector<std::byte*> slabs;
+    std::array<std::vector<void*>, CHUNK_SIZE_CLASS_COUNT> freeBlocks;
+    size_t slabUsed; // bytes handed out from the newest slab
+
+    struct Region {
+        void* base;
+        size_t size;
+        RegionType type;
+    };
+    std::vector<Region> regions;
+};
+
+// =============================================================================
+// ChunkAllocator Functions
+// =============================================================================
+
+ChunkAllocator::ChunkAllocator(bool useHugePages)
+    : useHugePages(useHugePages),
+      slabs({}),
+      freeBlocks({}),
+      slabUsed(SLAB_SIZE),
+      regions({}) {}
+
+ChunkAllocator::~ChunkAllocator() {
+    for (std::byte* slab : slabs) {
+        _freeSlab(slab);
+    }
+
+    for (const Region& region : regions) {
+        if (region.type == RegionType::HEAP) {
+            ::operator delete(region.base, std::align_val_t(CHUNK_MIN_SIZE));
+        }
+#if defined(__linux__) || defined(__APPLE__)
+        else {
+            munmap(region.base, region.size);
+        }
+#endif
+    }
+}
+
+void* ChunkAllocator::allocate(ChunkSizeClass sizeClass) {
+    ASSERT(size_t(sizeClass) < CHUNK_SIZE_CLASS_COUNT, "Invalid chunk size class.");
+    std::vector<void*>& blocks = freeBlocks[size_t(sizeClass)];
+    if (!blocks.empty()) {
+        void* block = blocks.back();
+        blocks.pop_back();
+        return block;
+    }
+
+    // align the bump offset to the block size, recycling what is skipped
+    size_t size = getChunkSize(sizeClass);
+    size_t offset = (slabUsed + size - 1) & ~(size - 1);
+    if (offset + size > SLAB_SIZE) {
+        _carve(SLAB_SIZE);
+        slabs.push_back(_allocateSlab());
+        slabUsed = 0;
+        offset = 0;
+    }
+    _carve(offset);
+
+    slabUsed = offset + size;
+    return slabs.back() + offset;
+}
+
+void ChunkAllocator::deallocate(void* block, ChunkSizeClass sizeClass) {
+    ASSERT(block != nullptr, "Cannot deallocate null chunk block.");
+    ASSERT(size_t(sizeClass) < CHUNK_SIZE_CLASS_COUNT, "Invalid chunk size class.");
+    freeBlocks[size_t(sizeClass)].push_back(block);
+}
+
+void ChunkAllocator::adoptRegion(void* base, size_t size, RegionType type) {
+    ASSERT(base != nullptr, "Cannot adopt null region.");
+    regions.push_back({base, size, type});
+}
+
+// splits the newest slab from slabUsed up to end into the largest blocks that
+// stay aligned and pushes them on the free lists
+void ChunkAllocator::_carve(size_t end) {
+    while (slabUsed < end) {
+        size_t c = CHUNK_SIZE_CLASS_COUNT;
+        size_t size = 0;
+        do {
+            c--;
+            size = getChunkSize(ChunkSizeClass(c));
+        } while (c > 0 && (slabUsed % size != 0 || slabUsed + size > end));
+
+        freeBlocks[c].push_back(slabs.back() + slabUsed);
+        slabUsed += size;
+    }
+}
+
+std::byte* ChunkAllocator::_allocateSlab() {
+#if defined(__linux__)
+    // over-allocate so the slab can be aligned to a huge page boundary
+    size_t size = SLAB_SIZE + SLAB_ALIGNMENT;
+    void* raw = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    ASSERT(raw != MAP_FAILED, "Failed to map chunk slab.");
+
+    uintptr_t beg = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (beg + SLAB_ALIGNMENT - 1) & ~(uintptr_t(SLAB_ALIGNMENT) - 1);
+    uintptr_t end = beg + size;
+
+    // trim the unaligned head and the unused tail
+    if (aligned > beg) munmap(raw, aligned - beg);
+    if (end > aligned + SLAB_SIZE) munmap(reinterpret_cast<void*>(aligned + SLAB_SIZE), end - aligned - SLAB_SIZE);
+
+    #ifdef MADV_HUGEPAGE
+    if (useHugePages) madvise(reinterpret_cast<void*>(aligned), SLAB_SIZE, MADV_HUGEPAGE);
+    #endif
+
+    return reinterpret_cast<std::byte*>(aligned);
+#elif defined(_WIN32)
+    // NOTE: large pages need SeLockMemoryPrivilege so they are not requested
+    void* slab = VirtualAlloc(nullptr, SLAB_SIZE, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+    ASSERT(slab != nullptr, "Failed to allocate chunk slab.");
+    return static_cast<std::byte*>(slab);
+#else
+    void* slab = ::operator new(SLAB_SIZE, std::align_val_t(64));
+    std::memset(slab, 0, SLAB_SIZE);
+    return static_cast<std::byte*>(slab);
+#endif
+}
+
+void ChunkAllocator::_freeSlab(std::byte* slab) {
+#if defined(__linux__)
+    munmap(slab, SLAB_SIZE);
+#elif defined(_WIN32)
+    VirtualFree(slab, 0, MEM_RELEASE);
+#else
+    ::operator delete(slab, std::align_val_t(64));
+#endif
+}
+
+} // namespace ECS
\ No newline at end of file
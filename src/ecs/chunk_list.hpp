@@ -7,9 +7,10 @@ namespace ECS {
 struct ChunkListKey {
     ArchetypeMask archetype;
     GroupID group;
+    SharedSetID shared;
 
     bool operator==(const ChunkListKey& other) const {
-        return archetype == other.archetype && group == other.group;
+        return archetype == other.archetype && group == other.group && shared == other.shared;
     }
 };
 
@@ -21,26 +22,34 @@ struct ChunkListHasher {
     size_t operator()(const ChunkListKey& key) const {
         size_t h1 = std::hash<ArchetypeMask>{}(key.archetype);
         size_t h2 = std::hash<GroupID>{}(key.group);
+        size_t h3 = std::hash<SharedSetID>{}(key.shared);
 
         // boost-style hash combine
         // return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2)); // TODO: need 32 bit or 64?
-        return h1 ^ (h2 + 0x9e3779b97f4a7c15ULL + (h1 << 6) + (h1 >> 2));       
+        h1 ^= h2 + 0x9e3779b97f4a7c15ULL + (h1 << 6) + (h1 >> 2);
+        return h1 ^ (h3 + 0x9e3779b97f4a7c15ULL + (h1 << 6) + (h1 >> 2));
     }
 };
 
 class ChunkList {
 public:
-    ChunkList(ChunkListKey key);
+    ChunkList(ChunkListKey key, const SharedSet* sharedSet);
 
     void insertChunk(Chunk* chunk);
     void removeChunk(Chunk* chunk);
     void insertChunkOpen(Chunk* chunk);
     void removeChunkOpen(Chunk* chunk);
+    void clear();
 
+    const ChunkListKey& getKey() const { return key; }
+    const SharedSet& getSharedSet() const { return *sharedSet; }
+    uint32_t getChunkCount() const { return count; }
+    Chunk* getHeadChunk() const { return headChunk; }
     Chunk* getNextOpenChunk() { return headChunkOpen; };
 
 private:
     ChunkListKey key;
+    const SharedSet* sharedSet;
     uint32_t count;
 
     Chunk* headChunk;     // list node to head chunk
@@ -49,8 +58,9 @@ private:
 	Chunk* tailChunkOpen; // list node to tail chunk with open entity slots
 };
 
-ChunkList::ChunkList(ChunkListKey key) {
+ChunkList::ChunkList(ChunkListKey key, const SharedSet* sharedSet) {
     this->key = key;
+    this->sharedSet = sharedSet;
     this->count = 0;
     this->headChunk = nullptr;
     this->tailChunk = nullptr;
@@ -92,6 +102,15 @@ void ChunkList::removeChunk(Chunk* chunk) {
     count--;
 }
 
+// forgets every chunk without touching them (the caller frees the chunks)
+void ChunkList::clear() {
+    headChunk = nullptr;
+    tailChunk = nullptr;
+    headChunkOpen = nullptr;
+    tailChunkOpen = nullptr;
+    count = 0;
+}
+
 void ChunkList::insertChunkOpen(Chunk* chunk) {
     chunk->nextChunkOpen = nullptr;
     chunk->prevChunkOpen = tailChunkOpen;
@@ -2,60 +2,159 @@
 
 #include "ecs/types.hpp"
 #include "ecs/archetype.hpp"
+#include "ecs/archetype_manager.hpp"
 #include "ecs/chunk.hpp"
+#include "ecs/chunk_allocator.hpp"
 #include "ecs/chunk_list.hpp"
 #include "ecs/component.hpp"
 #include "ecs/entity.hpp"
 #include "ecs/entity_manager.hpp"
+#include "ecs/query_manager.hpp"
+#include "ecs/shared_component_manager.hpp"
+#include "ecs/stats.hpp"
 #include "utils/assert.hpp"
+#include "utils/timer.hpp"
 
-#include <deque>
+#include <algorithm> // for std::min, std::sort, std::unique
+#include <array>
+#include <atomic>
+#include <new>       // for placement new
 #include <unordered_map>
 #include <vector>
 
 namespace ECS {
 
+// =============================================================================
+// ChunkManager Types
+// =============================================================================
+
+struct CompactionStats {
+    float fillBefore;     // entities / chunk capacity over all chunks, before
+    float fillAfter;      // and after the pass
+    uint32_t rowsMoved;
+    uint32_t chunksFreed;
+    bool finished;        // every list was compacted within the budget
+};
+
+// structural changes logged for the EventManager, MOVED only when the
+// archetype changes (group moves and compaction keep the archetype), in the
+// order EventManager::flush() reports them
+enum class StructuralEventType : uint8_t {
+    DESTROYED,
+    MOVED,
+    CREATED,
+};
+
+struct StructuralEvent {
+    EntityID eID;
+    StructuralEventType type;
+    const Archetype* from; // archetype before the change, nullptr for CREATED
+};
+
 // =============================================================================
 // ChunkManager
 // =============================================================================
 
 class ChunkManager {
+    friend class Autosave;
+    friend class Snapshot;
+
 public:
-    ChunkManager(ArchetypeManager& archetypeMgr, EntityManager& entityMgr);
+    ChunkManager(
+        ArchetypeManager& archetypeMgr,
+        EntityManager& entityMgr,
+        QueryManager& queryMgr,
+        SharedComponentManager& sharedMgr);
 
     // access
     bool   hasChunk(ChunkID id) const;
     Chunk& getChunk(ChunkID id);
-    bool       hasList(GroupID gID, Archetype& archetype) const;
-    ChunkList& getList(GroupID gID, Archetype& archetype);
+    bool       hasList(GroupID gID, Archetype& archetype, SharedSetID sID = SHARED_SET_ID_EMPTY) const;
+    ChunkList& getList(GroupID gID, Archetype& archetype, SharedSetID sID = SHARED_SET_ID_EMPTY);
+
+    // world version, stamped on chunk columns when they are written
+    uint32_t  getVersion() const { return version; }
+    std::atomic<uint32_t>& getVersionCounter() { return version; }
 
     // entity functions
     template<typename... Components>
-    void insertEntity(EntityID eID, ArchetypeID aID, GroupID gID, Components&&... data);
+    void insertEntity(EntityID eID, ArchetypeID aID, GroupID gID, SharedSetID sID, Components&&... data);
+    template<typename... Components>
+    void insertEntities(const EntityID* eIDs, size_t n, ArchetypeID aID, GroupID gID, SharedSetID sID, const Components&... prototypes);
+    template<typename... Components>
+    void insertEntityColumns(const EntityID* eIDs, size_t n, ArchetypeID aID, GroupID gID, SharedSetID sID, const Components*... columns);
     void removeEntity(EntityID eID);
-    // void moveEntityToGroup()
-    // void insertEntityComponent();
-    // void removeEntityComponent();
+    void removeEntitiesInList(ChunkList& list);
+    void removeEntitiesInChunk(Chunk& chunk);
+    void removeEntitiesInGroup(GroupID gID);
+    void moveEntityToGroup(EntityID eID, GroupID gID);
+    void moveEntitiesToGroup(const EntityID* eIDs, size_t n, GroupID gID);
+    template<typename C>
+    void insertEntityComponent(EntityID eID, C&& data);
+    void insertEntityComponent(EntityID eID, ComponentID cID, const void* data);
+    void removeEntityComponent(EntityID eID, ComponentID cID);
+    Chunk& moveEntity(EntityID eID, Archetype& dstArchetype, GroupID dstGroup, SharedSetID dstShared);
+
+    // compaction
+    CompactionStats compact(double budget);
+    float getFillFactor() const;
+
+    // stats
+    void getStats(WorldStats& stats) const;
+    const StructuralCounters& getCounters() const { return counters; }
+    void resetCounters() { counters = {}; }
+
+    // structural event log, only recorded while an observer exists
+    void setRecordEvents(bool record) { recordEvents = record; }
+    std::vector<StructuralEvent>& getEvents() { return events; }
 
     // miscellaneous
+    void setZeroFreedChunks(bool zero) { zeroFreedChunks = zero; }
     void print();
 
 private:
     // chunk management
-    Chunk* _newChunk(GroupID gID, Archetype& archetype);
+    Chunk* _newChunk(ChunkList& list, Archetype& archetype);
     void   _freeChunk(ChunkID cID);
+    ChunkSizeClass _selectSizeClass(Archetype& archetype);
+
+    // chunk adoption (see Snapshot)
+    void   _beginAdoption(ChunkID chunkCount);
+    Chunk& _adoptChunk(void* image, ChunkID cID, Archetype& archetype, GroupID gID, SharedSetID sID, ChunkSizeClass sizeClass, ChunkIdx count);
+    void   _endAdoption();
 
     // chunk list management
-    ChunkList& _getOrCreateList(GroupID gID, Archetype& archetype);
+    ChunkList& _getOrCreateList(GroupID gID, SharedSetID sID, Archetype& archetype);
+    ChunkList& _getListOf(Chunk& chunk);
+    Chunk* _getOrCreateOpenChunk(ChunkList& list, Archetype& archetype);
+    void _onRowInserted(ChunkList& list, Chunk& chunk);
+    void _onRowRemoved(ChunkList& list, Chunk& chunk, bool wasFull);
+    Chunk& _moveRow(EntityID eID, Chunk& srcChunk, ChunkList& srcList, ChunkList& dstList, Archetype& dstArchetype);
+    void _relinkChunk(Chunk& chunk, ChunkList& srcList, ChunkList& dstList);
+    bool _compactList(ChunkList& list, const Timer& timer, double budget, CompactionStats& stats);
+    void _recordEvents(const EntityID* eIDs, size_t n, StructuralEventType type, const Archetype* from);
 
     // manager references
     ArchetypeManager& archetypeMgr;
     EntityManager& entityMgr;
-
-    // chunk storage, empty chunks recycled for later reuse
-    std::deque<Chunk>    chunks;
-	std::vector<ChunkID> chunkFreeIDs;
+    QueryManager& queryMgr;
+    SharedComponentManager& sharedMgr;
+
+    // chunk storage, empty chunks keep their block and are recycled for reuse
+    // by chunks of the same size class
+    ChunkAllocator       chunkAllocator;
+    std::vector<Chunk*>  chunks;
+    std::array<std::vector<ChunkID>, CHUNK_SIZE_CLASS_COUNT> chunkFreeIDs;
     std::unordered_map<ChunkListKey, ChunkList, ChunkListHasher> lists;
+    std::vector<ChunkList*> listOrder; // lists in creation order, never shrinks
+    std::vector<ChunkList*> lastLists; // last list used per ArchetypeID
+    size_t compactCursor;              // next list to compact
+
+    std::atomic<uint32_t> version; // atomic so queries may run on worker threads
+    bool zeroFreedChunks;
+    StructuralCounters counters; // since the last resetCounters()
+    bool recordEvents;
+    std::vector<StructuralEvent> events; // since the last EventManager::flush()
 };
 
 // =============================================================================
@@ -64,12 +163,25 @@ private:
 
 ChunkManager::ChunkManager(
     ArchetypeManager& archetypeMgr,
-    EntityManager& entityMgr)
+    EntityManager& entityMgr,
+    QueryManager& queryMgr,
+    SharedComponentManager& sharedMgr)
         : archetypeMgr(archetypeMgr),
           entityMgr(entityMgr),
+          queryMgr(queryMgr),
+          sharedMgr(sharedMgr),
+          chunkAllocator(),
           chunks({}),
           chunkFreeIDs({}),
-          lists({}) {}
+          lists({}),
+          listOrder({}),
+          lastLists({}),
+          compactCursor(0),
+          version(1),
+          zeroFreedChunks(false),
+          counters({}),
+          recordEvents(false),
+          events({}) {}
 
 // =============================================================================
 // ChunkManager Access
@@ -77,25 +189,25 @@ ChunkManager::ChunkManager(
 
 bool ChunkManager::hasChunk(ChunkID id) const {
     if (id < static_cast<ChunkID>(chunks.size()))
-        return !(chunks[id].getChunkID() == CHUNK_ID_NULL);
+        return !(chunks[id]->getChunkID() == CHUNK_ID_NULL);
     return false;
 }
 
 Chunk& ChunkManager::getChunk(ChunkID id) {
     ASSERT(hasChunk(id), "ChunkID " << id << " does not exist.");
-    return chunks[id];
+    return *chunks[id];
 }
 
-bool ChunkManager::hasList(GroupID gID, Archetype& archetype) const {
-    ChunkListKey key{archetype.getMask(), gID};
+bool ChunkManager::hasList(GroupID gID, Archetype& archetype, SharedSetID sID) const {
+    ChunkListKey key{archetype.getMask(), gID, sID};
     auto it = lists.find(key);
     return (it != lists.end()) ? true : false;
 }
 
 
-ChunkList& ChunkManager::getList(GroupID gID, Archetype& archetype) {
-    ASSERT(hasList(gID, archetype), "List does not exist.");
-    ChunkListKey key{archetype.getMask(), gID};
+ChunkList& ChunkManager::getList(GroupID gID, Archetype& archetype, SharedSetID sID) {
+    ASSERT(hasList(gID, archetype, sID), "List does not exist.");
+    ChunkListKey key{archetype.getMask(), gID, sID};
     return lists.at(key);
 }
 
@@ -104,66 +216,352 @@ ChunkList& ChunkManager::getList(GroupID gID, Archetype& archetype) {
 // =============================================================================
 
 template<typename... Components>
-void ChunkManager::insertEntity(EntityID eID, ArchetypeID aID, GroupID gID, Components&&... data) {
+void ChunkManager::insertEntity(EntityID eID, ArchetypeID aID, GroupID gID, SharedSetID sID, Components&&... data) {
     Archetype& archetype = archetypeMgr.getArchetype(aID);
-    ChunkList& list = _getOrCreateList(gID, archetype);
-    Chunk* chunk = list.getNextOpenChunk();
+    ChunkList& list = _getOrCreateList(gID, sID, archetype);
+    Chunk* chunk = _getOrCreateOpenChunk(list, archetype);
 
-    // allocate new chunk if no empty slots available
-    if (!chunk || chunk->isFull()) {
-        chunk = _newChunk(gID, archetype);
-        list.insertChunk(chunk);
-        list.insertChunkOpen(chunk);
+    chunk->_insertEntity(eID, entityMgr, std::forward<Components>(data)...);
+
+    _onRowInserted(list, *chunk);
+    _recordEvents(&eID, 1, StructuralEventType::CREATED, nullptr);
+    counters.entitiesCreated++;
+}
+
+// fills the open chunks of the list first, then claims whole new chunks
+template<typename... Components>
+void ChunkManager::insertEntities(
+        const EntityID* eIDs,
+        size_t n,
+        ArchetypeID aID,
+        GroupID gID,
+        SharedSetID sID,
+        const Components&... prototypes) {
+    Archetype& archetype = archetypeMgr.getArchetype(aID);
+    ChunkList& list = _getOrCreateList(gID, sID, archetype);
+
+    for (size_t done = 0; done < n;) {
+        Chunk* chunk = _getOrCreateOpenChunk(list, archetype);
+        size_t space = chunk->getCapacity() - chunk->getCount();
+        ChunkIdx k = static_cast<ChunkIdx>(std::min(n - done, space));
+
+        chunk->_insertEntities(eIDs + done, k, entityMgr, prototypes...);
+
+        _onRowInserted(list, *chunk);
+        done += k;
     }
 
-    chunk->_insertEntity(eID, entityMgr, std::forward<Components>(data)...);
+    _recordEvents(eIDs, n, StructuralEventType::CREATED, nullptr);
+    counters.entitiesCreated += static_cast<uint32_t>(n);
+}
+
+template<typename... Components>
+void ChunkManager::insertEntityColumns(
+        const EntityID* eIDs,
+        size_t n,
+        ArchetypeID aID,
+        GroupID gID,
+        SharedSetID sID,
+        const Components*... columns) {
+    Archetype& archetype = archetypeMgr.getArchetype(aID);
+    ChunkList& list = _getOrCreateList(gID, sID, archetype);
 
-    // if chunk becomes full, remove it from open list
-    if (chunk->isFull()) {
-        list.removeChunkOpen(chunk);
+    for (size_t done = 0; done < n;) {
+        Chunk* chunk = _getOrCreateOpenChunk(list, archetype);
+        size_t space = chunk->getCapacity() - chunk->getCount();
+        ChunkIdx k = static_cast<ChunkIdx>(std::min(n - done, space));
+
+        chunk->_insertEntityColumns(eIDs + done, k, entityMgr, (columns + done)...);
+
+        _onRowInserted(list, *chunk);
+        done += k;
     }
+
+    _recordEvents(eIDs, n, StructuralEventType::CREATED, nullptr);
+    counters.entitiesCreated += static_cast<uint32_t>(n);
 }
 
 void ChunkManager::removeEntity(EntityID eID) {
     Entity& entity = entityMgr.getEntity(eID);
-    ChunkID cID = entity.getChunkID();
-    Chunk& chunk = getChunk(cID);
-
-    // Get chunk list for managing chunk state
-    // TODO: clean this up (maybe put ptr to chunk list in chunk?)
-    Archetype* archetype = chunk.getArchetype();
-    ChunkListKey key{archetype->getMask(), chunk.getGroupID()};
-    ChunkList& list = lists.at(key); // Should exist since chunk exists
+    Chunk& chunk = getChunk(entity.getChunkID());
+    ChunkList& list = _getListOf(chunk);
 
     bool wasFullBeforeRemoval = chunk.isFull();
 
+    _recordEvents(&eID, 1, StructuralEventType::DESTROYED, chunk.getArchetype());
     chunk._removeEntity(eID, entityMgr);
 
-    // if chunk becomes empty then remove it from lists and free it
-    if (chunk.isEmpty()) {
-        list.removeChunk(&chunk);
-        list.removeChunkOpen(&chunk);
-        _freeChunk(cID);
+    _onRowRemoved(list, chunk, wasFullBeforeRemoval);
+    counters.entitiesRemoved++;
+}
+
+// releases every chunk of the list whole: entity IDs are freed in one sweep
+// per chunk and no rows are moved
+void ChunkManager::removeEntitiesInList(ChunkList& list) {
+    Chunk* chunk = list.getHeadChunk();
+    list.clear();
+
+    while (chunk) {
+        Chunk* next = chunk->getNextChunk();
+        _recordEvents(chunk->getEntityIDs(), chunk->getCount(), StructuralEventType::DESTROYED, chunk->getArchetype());
+        entityMgr.freeEntities(chunk->getEntityIDs(), chunk->getCount());
+        counters.entitiesRemoved += chunk->getCount();
+        _freeChunk(chunk->getChunkID());
+        chunk = next;
     }
+}
 
-    // if chunk is no longer full then add it back to open list
-    else if (wasFullBeforeRemoval) {
-        list.insertChunkOpen(&chunk);
+// releases a single chunk whole, like removeEntitiesInList()
+void ChunkManager::removeEntitiesInChunk(Chunk& chunk) {
+    ChunkList& list = _getListOf(chunk);
+    bool wasFull = chunk.isFull();
+
+    _recordEvents(chunk.getEntityIDs(), chunk.getCount(), StructuralEventType::DESTROYED, chunk.getArchetype());
+    entityMgr.freeEntities(chunk.getEntityIDs(), chunk.getCount());
+    counters.entitiesRemoved += chunk.getCount();
+
+    list.removeChunk(&chunk);
+    if (!wasFull) list.removeChunkOpen(&chunk); // full chunks are not in open list
+    _freeChunk(chunk.getChunkID());
+}
+
+void ChunkManager::removeEntitiesInGroup(GroupID gID) {
+    for (auto& [key, list] : lists) {
+        if (key.group == gID)
+            removeEntitiesInList(list);
+    }
+}
+
+// =============================================================================
+// ChunkManager Structural Change Functions
+//
+// Adding or removing a component follows the archetype neighbor graph to the
+// destination archetype, then copies the shared columns of the entity row into
+// a chunk of that archetype (one memcpy per column) and swap-removes the row
+// from its source chunk. The entity keeps its ID, group and shared values.
+// =============================================================================
+
+template<typename C>
+void ChunkManager::insertEntityComponent(EntityID eID, C&& data) {
+    insertEntityComponent(eID, getComponentID<C>(), &data);
+}
+
+// inserting a component the entity already has overwrites its data
+void ChunkManager::insertEntityComponent(EntityID eID, ComponentID cID, const void* data) {
+    Entity& entity = entityMgr.getEntity(eID);
+    Chunk* chunk = &getChunk(entity.getChunkID());
+
+    if (!chunk->hasComponent(cID)) {
+        Archetype& dstArchetype = archetypeMgr.getInsertArchetype(*chunk->getArchetype(), cID);
+        chunk = &moveEntity(eID, dstArchetype, chunk->getGroupID(), chunk->getSharedSetID());
+    }
+
+    chunk->_setComponentData(entity.getChunkIdx(), cID, data);
+}
+
+// removing a component the entity does not have does nothing
+void ChunkManager::removeEntityComponent(EntityID eID, ComponentID cID) {
+    Entity& entity = entityMgr.getEntity(eID);
+    Chunk& chunk = getChunk(entity.getChunkID());
+
+    if (!chunk.hasComponent(cID)) return;
+
+    Archetype& dstArchetype = archetypeMgr.getRemoveArchetype(*chunk.getArchetype(), cID);
+    moveEntity(eID, dstArchetype, chunk.getGroupID(), chunk.getSharedSetID());
+}
+
+// relocates an entity row into a chunk of another archetype, group and/or
+// shared set
+Chunk& ChunkManager::moveEntity(EntityID eID, Archetype& dstArchetype, GroupID dstGroup, SharedSetID dstShared) {
+    Chunk& srcChunk = getChunk(entityMgr.getEntity(eID).getChunkID());
+    if (srcChunk.getArchetype() == &dstArchetype &&
+        srcChunk.getGroupID() == dstGroup &&
+        srcChunk.getSharedSetID() == dstShared)
+        return srcChunk;
+
+    ASSERT(dstArchetype.getMask().contains(sharedMgr.getSet(dstShared).mask),
+        "Archetype is missing components of its shared set.");
+
+    ChunkList& srcList = _getListOf(srcChunk);
+    ChunkList& dstList = _getOrCreateList(dstGroup, dstShared, dstArchetype);
+
+    if (srcChunk.getArchetype() != &dstArchetype)
+        _recordEvents(&eID, 1, StructuralEventType::MOVED, srcChunk.getArchetype());
+
+    return _moveRow(eID, srcChunk, srcList, dstList, dstArchetype);
+}
+
+// =============================================================================
+// ChunkManager Group Migration Functions
+//
+// Changing the group of an entity copies its row into a chunk list of the
+// same archetype and shared set. Batched moves visit entities chunk by chunk,
+// and a chunk whose every entity moves is relinked into the destination list
+// as is, so no rows are copied and the entities keep their chunk locations.
+// =============================================================================
+
+void ChunkManager::moveEntityToGroup(EntityID eID, GroupID gID) {
+    Chunk& chunk = getChunk(entityMgr.getEntity(eID).getChunkID());
+    moveEntity(eID, *chunk.getArchetype(), gID, chunk.getSharedSetID());
+}
+
+void ChunkManager::moveEntitiesToGroup(const EntityID* eIDs, size_t n, GroupID gID) {
+    struct Row {
+        ChunkID cID;
+        EntityID eID;
+    };
+
+    std::vector<Row> rows;
+    rows.reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        Entity& entity = entityMgr.getEntity(eIDs[i]);
+        if (getChunk(entity.getChunkID()).getGroupID() != gID)
+            rows.push_back({entity.getChunkID(), eIDs[i]});
+    }
+
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+        if (a.cID != b.cID) return a.cID < b.cID;
+        return a.eID < b.eID;
+    });
+    rows.erase(std::unique(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+        return a.eID == b.eID;
+    }), rows.end());
+
+    // a source chunk is either relinked whole or keeps some rows, so it is
+    // never freed and the chunk IDs in rows stay valid
+    for (size_t beg = 0, end = 0; beg < rows.size(); beg = end) {
+        ChunkID cID = rows[beg].cID;
+        end = beg + 1;
+        while (end < rows.size() && rows[end].cID == cID) end++;
+
+        Chunk& srcChunk = getChunk(cID);
+        Archetype& archetype = *srcChunk.getArchetype();
+        ChunkList& srcList = _getListOf(srcChunk);
+        ChunkList& dstList = _getOrCreateList(gID, srcChunk.getSharedSetID(), archetype);
+
+        if (end - beg == srcChunk.getCount()) {
+            _relinkChunk(srcChunk, srcList, dstList);
+            continue;
+        }
+
+        for (size_t i = beg; i < end; i++) {
+            _moveRow(rows[i].eID, srcChunk, srcList, dstList, archetype);
+        }
     }
 }
 
+// =============================================================================
+// ChunkManager Compaction Functions
+//
+// Churn leaves lists with many half empty chunks. A compaction pass moves the
+// rows of the sparsest open chunks of a list into its densest open chunks, so
+// that the emptied chunks are freed. Lists are visited round robin and the
+// pass stops once the time budget (seconds) is spent, resuming at the same
+// list on the next call, e.g. compact(0.0005) once per frame.
+// =============================================================================
+
+CompactionStats ChunkManager::compact(double budget) {
+    Timer timer;
+    CompactionStats stats{getFillFactor(), 0.0f, 0, 0, false};
+
+    for (size_t visited = 0; visited < listOrder.size(); visited++) {
+        if (compactCursor >= listOrder.size()) compactCursor = 0;
+        if (!_compactList(*listOrder[compactCursor], timer, budget, stats)) break;
+        compactCursor++;
+        stats.finished = (visited + 1 == listOrder.size());
+    }
+
+    if (listOrder.empty()) stats.finished = true;
+    stats.fillAfter = getFillFactor();
+    return stats;
+}
+
+// entities / (chunks * capacity), 1.0 when there are no chunks
+float ChunkManager::getFillFactor() const {
+    size_t entities = 0;
+    size_t capacity = 0;
+    for (const ChunkList* list : listOrder) {
+        for (const Chunk* c = list->getHeadChunk(); c; c = c->getNextChunk()) {
+            entities += c->getCount();
+            capacity += c->getCapacity();
+        }
+    }
+    return capacity ? float(double(entities) / double(capacity)) : 1.0f;
+}
+
+// =============================================================================
+// ChunkManager Stats Functions
+// =============================================================================
+
+// fills everything but the entity free list and frame counters (see World)
+void ChunkManager::getStats(WorldStats& stats) const {
+    stats.total = {};
+    stats.archetypes.resize(archetypeMgr.getArchetypeCount());
+    for (size_t i = 0; i < stats.archetypes.size(); i++) {
+        const Archetype& archetype = archetypeMgr.getArchetype(static_cast<ArchetypeID>(i));
+        stats.archetypes[i] = {};
+        stats.archetypes[i].id = archetype.getID();
+        stats.archetypes[i].mask = archetype.getMask();
+        stats.archetypes[i].sizeClass = archetype.getSizeClass();
+    }
+
+    stats.groups.clear();
+    for (const ChunkList* list : listOrder) {
+        if (list->getChunkCount() == 0) continue;
+
+        OccupancyStats occupancy{1, list->getChunkCount(), 0, 0, 0, 0};
+        const Archetype* archetype = list->getHeadChunk()->getArchetype();
+        for (const Chunk* c = list->getHeadChunk(); c; c = c->getNextChunk()) {
+            occupancy.entities += c->getCount();
+            occupancy.slots += c->getCapacity();
+            occupancy.chunkBytes += c->getSize();
+        }
+        occupancy.rowBytes = size_t(occupancy.entities) * archetype->getRowSize();
+
+        // groups are few, so a sorted vector beats a map and keeps its memory
+        GroupID gID = list->getKey().group;
+        auto it = std::lower_bound(stats.groups.begin(), stats.groups.end(), gID,
+            [](const GroupStats& g, GroupID id) { return g.id < id; });
+        if (it == stats.groups.end() || it->id != gID) {
+            it = stats.groups.insert(it, GroupStats{});
+            it->id = gID;
+        }
+
+        auto add = [&](OccupancyStats& dst) {
+            dst.lists    += occupancy.lists;
+            dst.chunks   += occupancy.chunks;
+            dst.entities += occupancy.entities;
+            dst.slots    += occupancy.slots;
+            dst.rowBytes += occupancy.rowBytes;
+            dst.chunkBytes += occupancy.chunkBytes;
+        };
+        add(stats.archetypes[archetype->getID()]);
+        add(*it);
+        add(stats.total);
+    }
+
+    stats.reservedBytes = chunkAllocator.getReservedBytes();
+    stats.freeChunkIDs = 0;
+    for (const std::vector<ChunkID>& freeIDs : chunkFreeIDs) {
+        stats.freeChunkIDs += static_cast<uint32_t>(freeIDs.size());
+    }
+    stats.frame = counters;
+}
+
 // =============================================================================
 // ChunkManager Miscellaneous Functions
 // =============================================================================
 
 void ChunkManager::print() {
     std::cout << "chunks:" << std::endl;
-    for (const Chunk& c : chunks) {
-        if (c.getChunkID() == CHUNK_ID_NULL) continue;
-        std::cout << "  - id: "       << c.getChunkID()  << std::endl;
-        std::cout << "    group: "    << c.getGroupID()  << std::endl;
-        std::cout << "    count: "    << c.getCount()    << std::endl;
-        std::cout << "    capacity: " << c.getCapacity() << std::endl;
+    for (const Chunk* c : chunks) {
+        if (c->getChunkID() == CHUNK_ID_NULL) continue;
+        std::cout << "  - id: "       << c->getChunkID()  << std::endl;
+        std::cout << "    group: "    << c->getGroupID()  << std::endl;
+        std::cout << "    shared: "   << c->getSharedSetID() << std::endl;
+        std::cout << "    size: "     << c->getSize()     << std::endl;
+        std::cout << "    count: "    << c->getCount()    << std::endl;
+        std::cout << "    capacity: " << c->getCapacity() << std::endl;
     }
 }
 
@@ -171,35 +569,264 @@ void ChunkManager::print() {
 // ChunkManager Private Functions
 // =============================================================================
 
-Chunk* ChunkManager::_newChunk(GroupID gID, Archetype& archetype) {
+Chunk* ChunkManager::_newChunk(ChunkList& list, Archetype& archetype) {
     ChunkID cID = CHUNK_ID_NULL;
+    GroupID gID = list.getKey().group;
+    const SharedSet* shared = &list.getSharedSet();
+
+    counters.chunksAllocated++;
 
-    if (!chunkFreeIDs.empty()) {
-        cID = chunkFreeIDs.back();
-        chunkFreeIDs.pop_back();
-        chunks[cID]._initialize(cID, gID, &archetype);
-        return &chunks[cID];
+    ChunkSizeClass sizeClass = _selectSizeClass(archetype);
+    archetype.chunkBytes += getChunkSize(sizeClass);
+
+    std::vector<ChunkID>& freeIDs = chunkFreeIDs[size_t(sizeClass)];
+    if (!freeIDs.empty()) {
+        cID = freeIDs.back();
+        freeIDs.pop_back();
+        chunks[cID]->_initialize(cID, gID, &archetype, shared, &version);
+        return chunks[cID];
     }
 
     cID = static_cast<ChunkID>(chunks.size());
-    chunks.emplace_back();
-    chunks.back()._initialize(cID, gID, &archetype);
-    return &chunks[cID];
+    Chunk* chunk = new (chunkAllocator.allocate(sizeClass)) Chunk(sizeClass);
+    chunk->_initialize(cID, gID, &archetype, shared, &version);
+    chunks.push_back(chunk);
+    return chunk;
 }
 
 void ChunkManager::_freeChunk(ChunkID cID) {
     ASSERT(hasChunk(cID), "ChunkID " << cID << " does not exist.");
-    chunks[cID]._clear();
-    chunkFreeIDs.push_back(cID);
+    Chunk& chunk = *chunks[cID];
+    Archetype& archetype = *chunk.getArchetype();
+
+    // an archetype that empties out starts over in its smallest class
+    archetype.chunkBytes -= chunk.getSize();
+    if (archetype.chunkBytes == 0 && !archetype.pinned) {
+        archetype.sizeClass = archetype.baseClass;
+    }
+
+    chunkFreeIDs[size_t(chunk.getSizeClass())].push_back(cID);
+    chunk._clear(zeroFreedChunks);
+    counters.chunksFreed++;
+}
+
+// sparse archetypes get small chunks so they do not pin mostly empty 64KB
+// blocks, populous ones move up a class once their chunks add up to a chunk
+// of the next class, trading slack in the last chunk for fewer chunk headers,
+// list links and per-chunk query overhead
+ChunkSizeClass ChunkManager::_selectSizeClass(Archetype& archetype) {
+    size_t next = size_t(archetype.sizeClass) + 1;
+    if (!archetype.pinned && next < CHUNK_SIZE_CLASS_COUNT &&
+        archetype.chunkBytes >= getChunkSize(ChunkSizeClass(next))) {
+        archetype.sizeClass = ChunkSizeClass(next);
+    }
+    return archetype.sizeClass;
 }
 
-ChunkList& ChunkManager::_getOrCreateList(GroupID gID, Archetype& archetype) {
-    ChunkListKey key{archetype.getMask(), gID};
+// sizes the chunk table of an empty manager, chunks are then adopted at their
+// original IDs and the remaining IDs become free chunks
+void ChunkManager::_beginAdoption(ChunkID chunkCount) {
+    ASSERT(chunks.empty(), "Chunks can only be adopted by an empty ChunkManager.");
+    chunks.resize(chunkCount, nullptr);
+}
+
+Chunk& ChunkManager::_adoptChunk(
+        void* image,
+        ChunkID cID,
+        Archetype& archetype,
+        GroupID gID,
+        SharedSetID sID,
+        ChunkSizeClass sizeClass,
+        ChunkIdx count) {
+    ASSERT(cID < chunks.size() && chunks[cID] == nullptr, "ChunkID " << cID << " cannot be adopted.");
+    ASSERT(count > 0, "Empty chunks are not adopted.");
+
+    ChunkList& list = _getOrCreateList(gID, sID, archetype);
+    Chunk* chunk = static_cast<Chunk*>(image);
+    chunk->_adopt(cID, gID, &archetype, &list.getSharedSet(), &version, sizeClass, count);
+    chunks[cID] = chunk;
+    archetype.chunkBytes += chunk->getSize();
+
+    list.insertChunk(chunk);
+    if (!chunk->isFull()) list.insertChunkOpen(chunk);
+
+    return *chunk;
+}
+
+void ChunkManager::_endAdoption() {
+    for (ChunkID cID = static_cast<ChunkID>(chunks.size()); cID-- > 0;) {
+        if (chunks[cID]) continue;
+        chunks[cID] = new (chunkAllocator.allocate(ChunkSizeClass::SMALL)) Chunk(ChunkSizeClass::SMALL);
+        chunkFreeIDs[size_t(ChunkSizeClass::SMALL)].push_back(cID);
+    }
+}
+
+// repeated inserts into one archetype and group skip the hash lookup, lists
+// are never erased so the cached pointers stay valid
+ChunkList& ChunkManager::_getOrCreateList(GroupID gID, SharedSetID sID, Archetype& archetype) {
+    if (archetype.getID() >= lastLists.size()) {
+        lastLists.resize(size_t(archetype.getID()) + 1, nullptr);
+    }
+
+    ChunkList*& last = lastLists[archetype.getID()];
+    if (last && last->getKey().group == gID && last->getKey().shared == sID) {
+        return *last;
+    }
+
+    ChunkListKey key{archetype.getMask(), gID, sID};
     auto it = lists.find(key);
     if (it == lists.end()) {
-        return lists.emplace(key, ChunkList(key)).first->second;
+        ChunkList& list = lists.emplace(key, ChunkList(key, &sharedMgr.getSet(sID))).first->second;
+        listOrder.push_back(&list);
+        queryMgr.onListCreated(list);
+        counters.listsCreated++;
+        last = &list;
+        return list;
     }
+
+    last = &it->second;
     return it->second;
 }
 
-} // namespace ECS
\ No newline at end of file
+// TODO: clean this up (maybe put ptr to chunk list in chunk?)
+ChunkList& ChunkManager::_getListOf(Chunk& chunk) {
+    ChunkListKey key{chunk.getArchetype()->getMask(), chunk.getGroupID(), chunk.getSharedSetID()};
+    return lists.at(key); // should exist since chunk exists
+}
+
+// allocate new chunk if no empty slots available
+Chunk* ChunkManager::_getOrCreateOpenChunk(ChunkList& list, Archetype& archetype) {
+    Chunk* chunk = list.getNextOpenChunk();
+
+    if (!chunk || chunk->isFull()) {
+        chunk = _newChunk(list, archetype);
+        list.insertChunk(chunk);
+        list.insertChunkOpen(chunk);
+    }
+
+    return chunk;
+}
+
+// if chunk becomes full, remove it from open list
+void ChunkManager::_onRowInserted(ChunkList& list, Chunk& chunk) {
+    if (chunk.isFull()) {
+        list.removeChunkOpen(&chunk);
+    }
+}
+
+// moves a row between lists, the source chunk is freed if it becomes empty
+Chunk& ChunkManager::_moveRow(
+        EntityID eID,
+        Chunk& srcChunk,
+        ChunkList& srcList,
+        ChunkList& dstList,
+        Archetype& dstArchetype) {
+    Chunk* dstChunk = _getOrCreateOpenChunk(dstList, dstArchetype);
+
+    bool wasFullBeforeRemoval = srcChunk.isFull();
+
+    dstChunk->_moveEntityFrom(srcChunk, eID, entityMgr);
+    counters.rowsMoved++;
+
+    _onRowInserted(dstList, *dstChunk);
+    _onRowRemoved(srcList, srcChunk, wasFullBeforeRemoval);
+
+    return *dstChunk;
+}
+
+// hands a whole chunk to another list of the same archetype and shared set
+void ChunkManager::_relinkChunk(Chunk& chunk, ChunkList& srcList, ChunkList& dstList) {
+    ASSERT(srcList.getKey().archetype == dstList.getKey().archetype &&
+           srcList.getKey().shared == dstList.getKey().shared,
+        "Chunks can only be relinked between lists of the same layout.");
+
+    srcList.removeChunk(&chunk);
+    if (!chunk.isFull()) srcList.removeChunkOpen(&chunk);
+
+    chunk.groupID = dstList.getKey().group;
+    chunk._markStructuralChange();
+
+    dstList.insertChunk(&chunk);
+    if (!chunk.isFull()) dstList.insertChunkOpen(&chunk);
+    counters.chunksRelinked++;
+}
+
+// returns false if the budget ran out before the list was compacted
+bool ChunkManager::_compactList(ChunkList& list, const Timer& timer, double budget, CompactionStats& stats) {
+    std::vector<Chunk*> open;
+    size_t rows = 0;
+    for (Chunk* c = list.getNextOpenChunk(); c; c = c->nextChunkOpen) {
+        open.push_back(c);
+        rows += c->getCount();
+    }
+
+    if (open.size() < 2) return true;
+
+    // sparsest chunks are drained into the densest
+    std::sort(open.begin(), open.end(), [](const Chunk* a, const Chunk* b) {
+        return a->getCount() < b->getCount();
+    });
+
+    // nothing to gain unless the rows fit without the sparsest chunk (chunks
+    // of a list may be of different size classes)
+    size_t capacity = 0;
+    for (const Chunk* c : open) capacity += c->getCapacity();
+    if (rows > capacity - open.front()->getCapacity()) return true;
+
+    size_t src = 0;
+    size_t dst = open.size() - 1;
+    while (src < dst) {
+        // always drain at least one chunk per pass so a tiny budget progresses
+        if (stats.rowsMoved > 0 && timer.elapsed() >= budget) return false;
+
+        Chunk& srcChunk = *open[src];
+        while (!srcChunk.isEmpty() && src < dst) {
+            Chunk& dstChunk = *open[dst];
+
+            // take the last row so the source chunk needs no swap
+            EntityID eID = srcChunk.getEntityIDs()[srcChunk.getCount() - 1];
+            dstChunk._moveEntityFrom(srcChunk, eID, entityMgr);
+            stats.rowsMoved++;
+            counters.rowsMoved++;
+
+            if (dstChunk.isFull()) {
+                _onRowInserted(list, dstChunk);
+                dst--;
+            }
+        }
+
+        if (srcChunk.isEmpty()) {
+            _onRowRemoved(list, srcChunk, false);
+            stats.chunksFreed++;
+            src++;
+        }
+    }
+
+    return true;
+}
+
+void ChunkManager::_onRowRemoved(ChunkList& list, Chunk& chunk, bool wasFull) {
+
+    // if chunk becomes empty then remove it from lists and free it
+    if (chunk.isEmpty()) {
+        list.removeChunk(&chunk);
+        if (!wasFull) list.removeChunkOpen(&chunk); // full chunks are not in open list
+        _freeChunk(chunk.getChunkID());
+    }
+
+    // if chunk is no longer full then add it back to open list
+    else if (wasFull) {
+        list.insertChunkOpen(&chunk);
+    }
+}
+
+// NOTE: a create logs the IDs after the rows are written, a destroy or move
+//       before the rows leave their chunk
+void ChunkManager::_recordEvents(const EntityID* eIDs, size_t n, StructuralEventType type, const Archetype* from) {
+    if (!recordEvents) return;
+    for (size_t i = 0; i < n; i++) {
+        events.push_back({eIDs[i], type, from});
+    }
+}
+
+} // namespace ECS
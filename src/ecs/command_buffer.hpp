@@ -0,0 +1,178 @@
+#pragma once
+
+#include "ecs/types.hpp"
+#include "utils/assert.hpp"
+
+#include <cstddef> // for std::byte
+#include <cstring> // for std::memcpy
+#include <type_traits>
+#include <vector>
+
+namespace ECS {
+
+// =============================================================================
+// Command
+// =============================================================================
+
+enum class CommandType : uint8_t {
+    CREATE_ENTITY,
+    REMOVE_ENTITY,
+    INSERT_COMPONENT,
+    REMOVE_COMPONENT,
+    MOVE_TO_GROUP,
+};
+
+struct CommandData {
+    ComponentID cID;
+    uint32_t offset; // byte offset of the component data in CommandBuffer::bytes
+};
+
+struct Command {
+    CommandType type;
+    EntityID eID;          // target entity (unused by CREATE_ENTITY)
+    GroupID gID;           // target group (CREATE_ENTITY and MOVE_TO_GROUP)
+    ArchetypeMask mask;    // component mask (CREATE_ENTITY only)
+    ComponentID cID;       // component (INSERT_COMPONENT and REMOVE_COMPONENT)
+    uint32_t dataBeg;      // first CommandData record
+    uint32_t dataEnd;      // one past last CommandData record
+};
+
+// =============================================================================
+// CommandBuffer
+//
+// Records structural changes so they can be applied later in one batch with
+// World::playback(). Nothing in the World is touched while recording, so
+// systems may record while iterating chunks, and each worker thread may fill
+// its own buffer to be merged at a sync point.
+//
+// NOTE: components must already be registered with the World before a buffer
+//       is recorded from a worker thread.
+//
+// Playback runs in three phases, each sorted so that every destination chunk
+// list is filled in one pass:
+//   1. removed entities
+//   2. inserted/removed components and group moves, folded per entity into a
+//      single move
+//   3. created entities, ordered by (archetype, group)
+// Structural changes on an entity removed in the same buffer are dropped.
+// =============================================================================
+
+class CommandBuffer {
+    friend class World;
+
+public:
+    CommandBuffer() : commands({}), records({}), bytes({}), created({}) {}
+
+    template<typename... Components>
+    void createEntity(Components&&... data);
+    template<typename... Components>
+    void createEntityInGroup(GroupID gID, Components&&... data);
+    void removeEntity(EntityID eID);
+    template <typename C>
+    void insertComponentIntoEntity(EntityID eID, C&& data = {});
+    template <typename C>
+    void removeComponentFromEntity(EntityID eID);
+    void moveEntityToGroup(EntityID eID, GroupID gID);
+
+    // append commands recorded in another buffer, leaving it empty
+    void merge(CommandBuffer& other);
+    void clear();
+
+    bool isEmpty() const { return commands.empty(); }
+    size_t getCount() const { return commands.size(); }
+
+    // entities created by the last playback, in recording order
+    const std::vector<EntityID>& getCreatedEntities() const { return created; }
+
+private:
+    template<typename C>
+    void _pushData(C&& data);
+
+    std::vector<Command> commands;
+    std::vector<CommandData> records;
+    std::vector<std::byte> bytes;
+    std::vector<EntityID> created;
+};
+
+// =============================================================================
+// CommandBuffer Functions
+// =============================================================================
+
+template<typename... Components>
+void CommandBuffer::createEntity(Components&&... data) {
+    createEntityInGroup(0, std::forward<Components>(data)...);
+}
+
+template<typename... Components>
+void CommandBuffer::createEntityInGroup(GroupID gID, Components&&... data) {
+    Command cmd{CommandType::CREATE_ENTITY, ENTITY_ID_NULL, gID, {}, COMPONENT_ID_NULL, 0, 0};
+    ((cmd.mask |= ArchetypeMask::bit(getComponentID<Components>())), ...);
+    cmd.dataBeg = static_cast<uint32_t>(records.size());
+    (_pushData(std::forward<Components>(data)), ...);
+    cmd.dataEnd = static_cast<uint32_t>(records.size());
+    commands.push_back(cmd);
+}
+
+void CommandBuffer::removeEntity(EntityID eID) {
+    uint32_t end = static_cast<uint32_t>(records.size());
+    commands.push_back({CommandType::REMOVE_ENTITY, eID, GROUP_ID_NULL, {}, COMPONENT_ID_NULL, end, end});
+}
+
+template <typename C>
+void CommandBuffer::insertComponentIntoEntity(EntityID eID, C&& data) {
+    Command cmd{CommandType::INSERT_COMPONENT, eID, GROUP_ID_NULL, {}, getComponentID<C>(), 0, 0};
+    cmd.dataBeg = static_cast<uint32_t>(records.size());
+    _pushData(std::forward<C>(data));
+    cmd.dataEnd = static_cast<uint32_t>(records.size());
+    commands.push_back(cmd);
+}
+
+template <typename C>
+void CommandBuffer::removeComponentFromEntity(EntityID eID) {
+    uint32_t end = static_cast<uint32_t>(records.size());
+    commands.push_back({CommandType::REMOVE_COMPONENT, eID, GROUP_ID_NULL, {}, getComponentID<C>(), end, end});
+}
+
+void CommandBuffer::moveEntityToGroup(EntityID eID, GroupID gID) {
+    uint32_t end = static_cast<uint32_t>(records.size());
+    commands.push_back({CommandType::MOVE_TO_GROUP, eID, gID, {}, COMPONENT_ID_NULL, end, end});
+}
+
+void CommandBuffer::merge(CommandBuffer& other) {
+    uint32_t recordBase = static_cast<uint32_t>(records.size());
+    uint32_t byteBase = static_cast<uint32_t>(bytes.size());
+
+    for (Command cmd : other.commands) {
+        cmd.dataBeg += recordBase;
+        cmd.dataEnd += recordBase;
+        commands.push_back(cmd);
+    }
+
+    for (CommandData rec : other.records) {
+        rec.offset += byteBase;
+        records.push_back(rec);
+    }
+
+    bytes.insert(bytes.end(), other.bytes.begin(), other.bytes.end());
+    other.clear();
+}
+
+void CommandBuffer::clear() {
+    commands.clear();
+    records.clear();
+    bytes.clear();
+}
+
+template<typename C>
+void CommandBuffer::_pushData(C&& data) {
+    using T = std::remove_cv_t<std::remove_reference_t<C>>;
+    uint32_t offset = static_cast<uint32_t>(bytes.size());
+    records.push_back({getComponentID<T>(), offset});
+
+    if constexpr (!std::is_empty_v<T>) {
+        bytes.resize(bytes.size() + sizeof(T));
+        std::memcpy(bytes.data() + offset, &data, sizeof(T));
+    }
+}
+
+} // namespace ECS
\ No newline at end of file
@@ -10,25 +10,25 @@ namespace ECS {
 
 class Component {
     friend class ComponentManager;
-    friend class Archetype;
 
 public:
     Component();
 
-    bool isTag() const { return size == 0; }
+    bool isTag()     const { return size == 0 && !shared; }
+    bool isShared()  const { return shared; }
+    bool isEnableable() const { return enableable; }
+    bool hasColumn() const { return size != 0; }
 
     ComponentID   getID()     const { return id; }
-    ComponentMask getMask()   const { return mask; }
+    const ComponentMask& getMask() const { return mask; }
     ComponentSize getSize()   const { return size; }
-    ComponentSize getOffset() const { return offset; }
 
 private:
-    void _setOffset(ComponentSize offset) { this->offset = offset; }
-
     ComponentID   id;     // unique component identifier
     ComponentMask mask;   // bitmask with single set bit at "id" (e.g. 1 << id)
     ComponentSize size;   // size in bytes of a single component element
-    ComponentSize offset; // chunk array offset (used in Archetype)
+    bool shared;          // value is stored once per chunk, not per entity
+    bool enableable;      // rows carry an enable bit (see enable_mask.hpp)
 };
 
 // =============================================================================
@@ -39,6 +39,7 @@ Component::Component()
     : id(COMPONENT_ID_NULL),
       mask(COMPONENT_MASK_NULL),
       size(COMPONENT_SIZE_NULL),
-      offset(COMPONENT_SIZE_NULL) {};
+      shared(false),
+      enableable(false) {};
 
 } // namespace ECS
\ No newline at end of file
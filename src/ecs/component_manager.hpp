@@ -30,7 +30,7 @@ constexpr bool IsTagType = std::is_empty_v<T>;
 
 class ComponentManager {
 public:
-    ComponentManager() : components({}), count{0} {}
+    ComponentManager() : components({}), count{0}, enableableMask() {}
 
     template <typename T>
     bool hasComponent() const;
@@ -38,6 +38,13 @@ public:
     template <typename T>
     bool isTag() const;
     bool isTag(ComponentID id) const;
+    template <typename T>
+    bool isShared() const;
+    bool isShared(ComponentID id) const;
+    template <typename T>
+    bool isEnableable() const;
+    bool isEnableable(ComponentID id) const;
+    const ArchetypeMask& getEnableableMask() const { return enableableMask; }
 
     template <typename T>
     Component getComponent();
@@ -45,12 +52,17 @@ public:
 
     template <typename T>
     Component& registerComponent();
+    template <typename T>
+    Component& registerSharedComponent();
+    template <typename T>
+    Component& registerEnableableComponent();
 
     void print();
 
 private:
     std::array<Component, COMPONENT_CAPACITY> components;
     ComponentID count;
+    ArchetypeMask enableableMask;
 };
 
 // =============================================================================
@@ -75,6 +87,24 @@ bool ComponentManager::isTag(ComponentID id) const {
     return components[id].isTag();
 }
 
+template <typename T>
+bool ComponentManager::isShared() const {
+    return isShared(getComponentID<T>());
+}
+
+bool ComponentManager::isShared(ComponentID id) const {
+    return components[id].isShared();
+}
+
+template <typename T>
+bool ComponentManager::isEnableable() const {
+    return isEnableable(getComponentID<T>());
+}
+
+bool ComponentManager::isEnableable(ComponentID id) const {
+    return components[id].isEnableable();
+}
+
 template <typename T>
 Component ComponentManager::getComponent() {
     return getComponent(getComponentID<T>());
@@ -92,25 +122,57 @@ Component& ComponentManager::registerComponent() {
 
     ComponentID id = getComponentID<T>();
     ASSERT(count < COMPONENT_CAPACITY, "Component registry full.");
-    ASSERT(id < COMPONENT_CAPACITY, "Component id must be between 0 and 63");
+    ASSERT(id < COMPONENT_CAPACITY, "Component id must be below COMPONENT_CAPACITY (" << COMPONENT_CAPACITY << ").");
     ASSERT(!hasComponent(id), "Component already registered.");
 
+    // IDs from the registration table are claimed here (see ECS_COMPONENT_ID)
+    bool claimed = ComponentRegistry::claim(id, getTypeHash<T>());
+    ASSERT(claimed, "Component id " << id << " belongs to another type.");
+    (void)claimed;
+
     Component& c = components[id];
     c.id   = id;
-    c.mask = ComponentMask(1) << id;
+    c.mask = ComponentMask::bit(id);
     c.size = IsTagType<T> ? 0 : sizeof(T);
     count++;
 
     return c;
 }
 
+// shared components take a bit in the archetype mask but no chunk column, their
+// value lives once per chunk in the chunk's SharedSet
+template <typename T>
+Component& ComponentManager::registerSharedComponent() {
+    static_assert(IsComponentType<T> && !IsTagType<T>,
+        "Type T is not a valid shared component (must be POD-like and non-empty).");
+
+    Component& c = registerComponent<T>();
+    c.size   = 0;
+    c.shared = true;
+
+    return c;
+}
+
+// enableable components (tags included) get an enable bit per row next to
+// their column, so they can be switched off without moving the entity
+template <typename T>
+Component& ComponentManager::registerEnableableComponent() {
+    Component& c = registerComponent<T>();
+    c.enableable = true;
+    enableableMask.set(c.getID());
+
+    return c;
+}
+
 void ComponentManager::print() {
     std::cout << "components:" << std::endl;
-    for (ComponentID id = 0; id < count; id++) {
-        const Component& c = components[id];
+    for (const Component& c : components) {
+        if (c.getID() == COMPONENT_ID_NULL) continue;
         std::cout << "  - id: "   << (int)c.getID()   << std::endl;
         std::cout << "    mask: " <<      c.getMask() << std::endl;
         std::cout << "    size: " <<      c.getSize() << std::endl;
+        std::cout << "    shared: " <<    c.isShared() << std::endl;
+        std::cout << "    enableable: " << c.isEnableable() << std::endl;
     }
 }
 
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "ecs/types.hpp"
+#include "utils/assert.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <stdexcept> // for std::runtime_error
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+namespace ECS {
+
+// =============================================================================
+// Type Names
+//
+// Compile time name and FNV-1a hash of a type, taken from the signature of a
+// function template. The name includes the namespaces of the type, so it is
+// the same in every binary built by the same compiler.
+//
+// NOTE: types in anonymous namespaces share a name across translation units.
+// =============================================================================
+
+template <typename T>
+constexpr std::string_view getTypeName() {
+#if defined(__clang__) || defined(__GNUC__)
+    // "... getTypeName() [with T = Position; ...]" or "... getTypeName() [T = Position]"
+    std::string_view name = __PRETTY_FUNCTION__;
+    size_t beg = name.find("T = ") + 4;
+    size_t end = name.find_first_of(";]", beg);
+    return name.substr(beg, end - beg);
+#elif defined(_MSC_VER)
+    // "... getTypeName<struct Position>(void)"
+    std::string_view name = __FUNCSIG__;
+    size_t beg = name.find("getTypeName<") + 12;
+    size_t end = name.rfind(">(void)");
+    return name.substr(beg, end - beg);
+#else
+    #error "ECS type names need __PRETTY_FUNCTION__ or __FUNCSIG__"
+#endif
+}
+
+constexpr uint64_t hashTypeName(std::string_view name) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (char c : name) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ULL;
+    }
+    return hash ? hash : 1; // 0 marks a free registry slot
+}
+
+template <typename T>
+constexpr uint64_t getTypeHash() {
+    return hashTypeName(getTypeName<T>());
+}
+
+// =============================================================================
+// Component IDs
+//
+// Component IDs index the bits of an ArchetypeMask. A type takes its ID from
+// the registration table when it is listed there, so IDs that snapshots and
+// replays depend on are fixed in one place:
+//
+//   ECS_COMPONENT_ID(Position, 0);
+//   ECS_COMPONENT_ID(Velocity, 1);
+//
+// Listed IDs are below COMPONENT_FIXED_ID_COUNT. Unlisted types take the ID
+// their type name hash maps to in the IDs above the first time
+// getComponentID<T>() runs, so it is the same in every run and translation
+// unit. Both paths are safe to call from any thread.
+//
+// NOTE: two unlisted types whose hashes map to the same ID are not probed
+//       apart, since which one came first would decide the IDs. The second
+//       one throws std::runtime_error naming it, list it with
+//       ECS_COMPONENT_ID. Snapshots store IDs with their type hash and reject
+//       a World whose IDs differ, they are not remapped.
+// =============================================================================
+
+// specialized by ECS_COMPONENT_ID
+template <typename T>
+struct ComponentTraits {};
+
+template <typename T, typename = void>
+constexpr bool HasFixedComponentID = false;
+
+template <typename T>
+constexpr bool HasFixedComponentID<T, std::void_t<decltype(ComponentTraits<T>::ID)>> = true;
+
+#define ECS_COMPONENT_ID(Type, Id)                                  \
+    template <>                                                     \
+    struct ECS::ComponentTraits<Type> {                             \
+        static constexpr ECS::ComponentID ID = Id;                  \
+        static_assert(Id < ECS::COMPONENT_FIXED_ID_COUNT,           \
+            "Component ID of " #Type " exceeds ECS_FIXED_COMPONENT_IDS"); \
+    }
+
+// =============================================================================
+// ComponentRegistry
+//
+// Process wide table from component ID to type hash. Slots are claimed with a
+// single compare-and-swap, so types may be first used on any thread without a
+// lock, and a second type claiming a taken ID is caught.
+// =============================================================================
+
+class ComponentRegistry {
+public:
+    static ComponentID acquire(uint64_t typeHash, std::string_view typeName);
+    static bool claim(ComponentID id, uint64_t typeHash);
+    static uint64_t getTypeHash(ComponentID id);
+
+private:
+    static std::array<std::atomic<uint64_t>, COMPONENT_CAPACITY>& _slots();
+};
+
+// returns the ID the hash of the type maps to, throws if another type has it
+inline ComponentID ComponentRegistry::acquire(uint64_t typeHash, std::string_view typeName) {
+    size_t id = COMPONENT_FIXED_ID_COUNT + typeHash % (COMPONENT_CAPACITY - COMPONENT_FIXED_ID_COUNT);
+    uint64_t expected = 0;
+    if (_slots()[id].compare_exchange_strong(expected, typeHash, std::memory_order_acq_rel) || expected == typeHash)
+        return static_cast<ComponentID>(id);
+
+    // checked in every build, probing would make the ID depend on use order
+    throw std::runtime_error("Error: Component " + std::string(typeName) + " hashes to component id " +
+        std::to_string(id) + " of another type, list it with ECS_COMPONENT_ID.");
+}
+
+// true if the ID was free or already belongs to the type
+inline bool ComponentRegistry::claim(ComponentID id, uint64_t typeHash) {
+    uint64_t expected = 0;
+    return _slots()[id].compare_exchange_strong(expected, typeHash, std::memory_order_acq_rel) || expected == typeHash;
+}
+
+// type hash of the component ID, 0 if the ID is unused
+inline uint64_t ComponentRegistry::getTypeHash(ComponentID id) {
+    return _slots()[id].load(std::memory_order_acquire);
+}
+
+inline std::array<std::atomic<uint64_t>, COMPONENT_CAPACITY>& ComponentRegistry::_slots() {
+    static std::array<std::atomic<uint64_t>, COMPONENT_CAPACITY> slots{}; // zeroed before first use
+    return slots;
+}
+
+template <typename C>
+inline ComponentID getComponentID() {
+    // const and reference qualified types share the ID of the bare type
+    using T = std::remove_cv_t<std::remove_reference_t<C>>;
+    if constexpr (!std::is_same_v<C, T>) {
+        return getComponentID<T>();
+    } else if constexpr (HasFixedComponentID<T>) {
+        return ComponentTraits<T>::ID;
+    } else {
+        static const ComponentID id = ComponentRegistry::acquire(getTypeHash<T>(), getTypeName<T>());
+        return id;
+    }
+}
+
+// =============================================================================
+// Archetype Signature
+//
+// A type pack (e.g. the components of createEntity()) resolves to its
+// archetype mask once per process and to a dense signature ID that indexes
+// the per World archetype cache (see ArchetypeManager::getOrCreateArchetype).
+// Packs listing the same components in another order get their own signature
+// ID but share the mask, so they resolve to the same archetype.
+// =============================================================================
+
+inline size_t getNextSignatureID() {
+    static std::atomic<size_t> counter{0};
+    return counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename... Cs>
+inline size_t getSignatureID() {
+    static const size_t id = getNextSignatureID();
+    return id;
+}
+
+template <typename... Cs>
+inline ArchetypeMask getSignatureMask() {
+    static const ArchetypeMask mask = (ArchetypeMask() | ... | ArchetypeMask::bit(getComponentID<Cs>()));
+    return mask;
+}
+
+} // namespace ECS
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "ecs/types.hpp"
+
+#include <cstddef> // for size_t
+#include <cstdint>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+namespace ECS {
+
+// =============================================================================
+// Enable Masks
+//
+// An enableable component has one bit per row in each chunk, set while the
+// component is enabled (see World::registerEnableableComponent()). Bits of
+// rows past the chunk count are kept clear, so a mask can be scanned a word at
+// a time without looking at the count.
+//
+// The kernels below combine the masks of a query into the rows it visits and
+// walk them as runs of set bits: one bit scan per run boundary, and one SIMD
+// compare per 128 (SSE2) or 256 (AVX2) rows to find chunks with every row set.
+// =============================================================================
+
+constexpr size_t getEnableMaskWords(ChunkIdx capacity) {
+    return (size_t(capacity) + 63) / 64;
+}
+
+inline uint32_t countTrailingZeros(uint64_t word) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<uint32_t>(index);
+#else
+    return static_cast<uint32_t>(__builtin_ctzll(word));
+#endif
+}
+
+inline uint32_t countBits(uint64_t word) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return static_cast<uint32_t>(__popcnt64(word));
+#else
+    return static_cast<uint32_t>(__builtin_popcountll(word));
+#endif
+}
+
+// bits of the rows below count in word i
+inline uint64_t getEnableMaskValid(size_t i, ChunkIdx count) {
+    size_t rows = size_t(count) - i * 64;
+    return rows >= 64 ? ~uint64_t(0) : (uint64_t(1) << rows) - 1;
+}
+
+// true if rows [0, count) are all set
+inline bool isEnableMaskFull(const uint64_t* ECS_RESTRICT bits, ChunkIdx count) {
+    size_t full = size_t(count) / 64;
+    size_t i = 0;
+
+#if defined(ECS_BITSET_AVX2)
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    for (; i + 4 <= full; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits + i));
+        if (!_mm256_testc_si256(v, ones)) return false;
+    }
+#endif
+#if defined(ECS_BITSET_SSE2)
+    const __m128i ones128 = _mm_set1_epi32(-1);
+    for (; i + 2 <= full; i += 2) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bits + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, ones128)) != 0xFFFF) return false;
+    }
+#endif
+    for (; i < full; i++) {
+        if (bits[i] != ~uint64_t(0)) return false;
+    }
+
+    return (count % 64 == 0) || (bits[full] == getEnableMaskValid(full, count));
+}
+
+inline size_t countEnabledRows(const uint64_t* bits, ChunkIdx count) {
+    size_t n = 0;
+    for (size_t i = 0; i < getEnableMaskWords(count); i++) n += countBits(bits[i]);
+    return n;
+}
+
+// first row at or after from whose bit equals value, count if there is none
+inline size_t findEnableBit(const uint64_t* bits, size_t from, ChunkIdx count, bool value) {
+    size_t words = getEnableMaskWords(count);
+    size_t i = from / 64;
+    if (i >= words) return count;
+
+    uint64_t flip = value ? 0 : ~uint64_t(0);
+    uint64_t word = (bits[i] ^ flip) & (~uint64_t(0) << (from % 64));
+    while (word == 0) {
+        if (++i >= words) return count;
+        word = bits[i] ^ flip;
+    }
+
+    size_t row = i * 64 + countTrailingZeros(word);
+    return row < count ? row : count;
+}
+
+// calls fn(beg, end) for every run of set bits in rows [0, count)
+template <typename Fn>
+void forEachEnabledRun(const uint64_t* bits, ChunkIdx count, Fn&& fn) {
+    size_t beg = findEnableBit(bits, 0, count, true);
+    while (beg < count) {
+        size_t end = findEnableBit(bits, beg, count, false);
+        fn(static_cast<ChunkIdx>(beg), static_cast<ChunkIdx>(end));
+        beg = findEnableBit(bits, end, count, true);
+    }
+}
+
+} // namespace ECS
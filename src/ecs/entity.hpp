@@ -12,12 +12,13 @@ class Entity {
     friend class EntityManager;
 
 public:
-    Entity() { nullify(); }
+    Entity() : generation(0) { nullify(); }
     void nullify();
 
     EntityID getID()       const { return id;       }
     ChunkID  getChunkID()  const { return chunkID;  };
     ChunkIdx getChunkIdx() const { return chunkIdx; };
+    EntityGeneration getGeneration() const { return generation; }
 
 private:
     void _set(ChunkID chunkID, ChunkIdx chunkIdx);
@@ -25,6 +26,7 @@ private:
     EntityID id;       // unique entity identifier
     ChunkID  chunkID;  // entity exists in this chunk
     ChunkIdx chunkIdx; // entity exists in this chunk index
+    EntityGeneration generation; // bumped when the ID is freed, kept by nullify()
 };
 
 // =============================================================================
@@ -4,6 +4,7 @@
 #include "ecs/entity.hpp"
 #include "utils/assert.hpp"
 
+#include <algorithm> // for std::min
 #include <vector>
 
 namespace ECS {
@@ -13,19 +14,29 @@ namespace ECS {
 // =============================================================================
 
 class EntityManager {
+    friend class Snapshot;
+
 public:
     EntityManager() : entities({}), freeIDs({}) {}
 
     bool    hasEntity(EntityID id) const;
     Entity& getEntity(EntityID id);
     void    setEntity(EntityID id, ChunkID chunkID, ChunkIdx chunkIdx);
+    void    setEntities(const EntityID* ids, size_t n, ChunkID chunkID, ChunkIdx chunkIdx);
 
     EntityID createEntity();
+    void createEntities(size_t n, EntityID* ids);
     void freeEntity(EntityID id);
+    void freeEntities(const EntityID* ids, size_t n);
 
+    size_t getCapacity()  const { return entities.size(); }
+    size_t getFreeCount() const { return freeIDs.size(); }
     void print();
 
 private:
+    void _restoreEntity(EntityID id, ChunkID chunkID, ChunkIdx chunkIdx);
+    void _restoreGeneration(EntityID id, EntityGeneration generation);
+
     std::vector<Entity> entities;
     std::vector<EntityID> freeIDs;
 };
@@ -50,6 +61,14 @@ void EntityManager::setEntity(EntityID id, ChunkID chunkID, ChunkIdx chunkIdx) {
     entities[id]._set(chunkID, chunkIdx);
 }
 
+// sets consecutive chunk indices starting at chunkIdx
+void EntityManager::setEntities(const EntityID* ids, size_t n, ChunkID chunkID, ChunkIdx chunkIdx) {
+    for (size_t i = 0; i < n; i++) {
+        ASSERT(hasEntity(ids[i]), "EntityID " << ids[i] << " does not exist.");
+        entities[ids[i]]._set(chunkID, static_cast<ChunkIdx>(chunkIdx + i));
+    }
+}
+
 EntityID EntityManager::createEntity() {
     EntityID id = ENTITY_ID_NULL;
 
@@ -66,12 +85,54 @@ EntityID EntityManager::createEntity() {
     return id;
 }
 
+// reserves n IDs, recycling free IDs first then growing the table once
+void EntityManager::createEntities(size_t n, EntityID* ids) {
+    size_t numRecycled = std::min(n, freeIDs.size());
+    for (size_t i = 0; i < numRecycled; i++) {
+        EntityID id = freeIDs.back();
+        freeIDs.pop_back();
+        entities[id].id = id;
+        ids[i] = id;
+    }
+
+    EntityID first = static_cast<EntityID>(entities.size());
+    entities.resize(entities.size() + (n - numRecycled));
+    for (size_t i = numRecycled; i < n; i++) {
+        EntityID id = static_cast<EntityID>(first + (i - numRecycled));
+        entities[id].id = id;
+        ids[i] = id;
+    }
+}
+
 void EntityManager::freeEntity(EntityID id) {
     ASSERT(hasEntity(id), "EntityID " << id << " does not exist.");
     entities[id].nullify();
+    entities[id].generation++;
     freeIDs.push_back(id);
 }
 
+void EntityManager::freeEntities(const EntityID* ids, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        ASSERT(hasEntity(ids[i]), "EntityID " << ids[i] << " does not exist.");
+        entities[ids[i]].nullify();
+        entities[ids[i]].generation++;
+    }
+    freeIDs.insert(freeIDs.end(), ids, ids + n);
+}
+
+// grows the table as needed, used to rebuild a table from a snapshot
+void EntityManager::_restoreEntity(EntityID id, ChunkID chunkID, ChunkIdx chunkIdx) {
+    if (id >= entities.size()) entities.resize(size_t(id) + 1);
+    entities[id].id = id;
+    entities[id]._set(chunkID, chunkIdx);
+}
+
+// grows the table as needed, free IDs keep their generation too
+void EntityManager::_restoreGeneration(EntityID id, EntityGeneration generation) {
+    if (id >= entities.size()) entities.resize(size_t(id) + 1);
+    entities[id].generation = generation;
+}
+
 void EntityManager::print() {
     std::cout << "entities:" << std::endl;
     for (const Entity& e : entities) {
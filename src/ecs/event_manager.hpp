@@ -0,0 +1,250 @@
+#pragma once
+
+#include "ecs/types.hpp"
+#include "ecs/archetype.hpp"
+#include "ecs/chunk.hpp"
+#include "ecs/chunk_manager.hpp"
+#include "ecs/entity_manager.hpp"
+#include "utils/assert.hpp"
+
+#include <algorithm> // for std::sort, std::stable_sort
+#include <functional>
+#include <iostream>
+#include <vector>
+
+namespace ECS {
+
+// =============================================================================
+// Observer Types
+// =============================================================================
+
+// entities of one chunk (or, when destroyed, one former archetype) with the
+// same net change since the previous flush
+struct ObserverBatch {
+    StructuralEventType type;
+    const EntityID* eIDs;  // sorted by row for CREATED and MOVED
+    uint32_t count;
+    Chunk* chunk;          // chunk holding the entities, nullptr for DESTROYED
+    const Archetype* from; // archetype before the flush, nullptr for CREATED
+};
+
+using ObserverFn = std::function<void(const ObserverBatch&)>;
+
+// =============================================================================
+// EventManager
+//
+// Tells observers which entities were created, destroyed or moved to another
+// archetype. The ChunkManager only logs the entity IDs while an observer
+// exists, and flush() folds the log per entity into its net change since the
+// previous flush:
+//
+//   created               CREATED (created then destroyed reports nothing)
+//   destroyed             DESTROYED with the archetype it had at the last flush
+//   archetype changed     MOVED, unless it is back in its old archetype
+//   destroyed, ID reused  DESTROYED and CREATED
+//
+// Batches hold the entity IDs of one chunk, so an observer keeps a derived
+// structure in sync with one call per chunk instead of one per entity:
+//
+//   world.observe<Position, Selected>([&](const ObserverBatch& b) { ... });
+//
+// An observer sees the batches whose archetype contains its components, for
+// MOVED either the old or the new archetype (compare b.from with the chunk to
+// tell entering from leaving). Group moves and compaction keep the archetype
+// and are not reported, nor are entities loaded from a Snapshot.
+//
+// NOTE: observers must not make structural changes, record them in a
+//       CommandBuffer instead
+// =============================================================================
+
+class EventManager {
+public:
+    EventManager(ChunkManager& chunkMgr, EntityManager& entityMgr);
+
+    ObserverID addObserver(const ArchetypeMask& mask, ObserverFn fn);
+    void removeObserver(ObserverID id);
+    bool hasObserver(ObserverID id) const;
+
+    void flush();
+
+    void print();
+
+private:
+    struct Observer {
+        ArchetypeMask mask;
+        ObserverFn fn;
+    };
+
+    // net change of one entity, sorted into batches
+    struct Row {
+        StructuralEventType type;
+        EntityID eID;
+        Chunk* chunk;
+        const Archetype* from;
+        ChunkIdx idx;
+    };
+
+    void _foldEvents();
+    void _dispatch(const ObserverBatch& batch);
+
+    ChunkManager& chunkMgr;
+    EntityManager& entityMgr;
+
+    std::vector<Observer> observers; // indexed by ObserverID, removed ones have no fn
+    size_t observerCount;
+    bool flushing;
+
+    // flush buffers, kept to reuse their memory
+    std::vector<StructuralEvent> log;
+    std::vector<Row> rows;
+    std::vector<EntityID> ids;
+};
+
+// =============================================================================
+// EventManager Functions
+// =============================================================================
+
+EventManager::EventManager(ChunkManager& chunkMgr, EntityManager& entityMgr)
+    : chunkMgr(chunkMgr),
+      entityMgr(entityMgr),
+      observers({}),
+      observerCount(0),
+      flushing(false),
+      log({}),
+      rows({}),
+      ids({}) {}
+
+// an empty mask observes every entity, changes made before the first observer
+// was added are not reported
+ObserverID EventManager::addObserver(const ArchetypeMask& mask, ObserverFn fn) {
+    ASSERT(!flushing, "Observers cannot be added during a flush.");
+    ASSERT(observers.size() < OBSERVER_ID_NULL, "Observer registry full.");
+    ASSERT(fn, "Observer has no function.");
+
+    observers.push_back({mask, std::move(fn)});
+    observerCount++;
+    chunkMgr.setRecordEvents(true);
+    return static_cast<ObserverID>(observers.size() - 1);
+}
+
+void EventManager::removeObserver(ObserverID id) {
+    ASSERT(!flushing, "Observers cannot be removed during a flush.");
+    ASSERT(hasObserver(id), "ObserverID " << id << " does not exist.");
+
+    observers[id].fn = nullptr;
+    observerCount--;
+    if (observerCount == 0) {
+        chunkMgr.setRecordEvents(false);
+        chunkMgr.getEvents().clear();
+    }
+}
+
+bool EventManager::hasObserver(ObserverID id) const {
+    return id < observers.size() && observers[id].fn;
+}
+
+// reports the changes logged since the previous flush, destroyed entities
+// first, then moved, then created ones
+void EventManager::flush() {
+    ASSERT(!flushing, "EventManager::flush() is not reentrant.");
+    if (chunkMgr.getEvents().empty()) return;
+
+    flushing = true;
+    log.clear();
+    log.swap(chunkMgr.getEvents());
+    _foldEvents();
+
+    for (size_t beg = 0, end = 0; beg < rows.size(); beg = end) {
+        const Row& first = rows[beg];
+        end = beg + 1;
+        while (end < rows.size() &&
+               rows[end].type == first.type &&
+               rows[end].chunk == first.chunk &&
+               rows[end].from == first.from)
+            end++;
+
+        _dispatch({first.type, ids.data() + beg, static_cast<uint32_t>(end - beg), first.chunk, first.from});
+    }
+    flushing = false;
+}
+
+void EventManager::print() {
+    std::cout << "observers:" << std::endl;
+    for (size_t i = 0; i < observers.size(); i++) {
+        if (!observers[i].fn) continue;
+        std::cout << "  - id: "   << i                << std::endl;
+        std::cout << "    mask: " << observers[i].mask << std::endl;
+    }
+    std::cout << "events:" << std::endl;
+    std::cout << "  pending: " << chunkMgr.getEvents().size() << std::endl;
+}
+
+// =============================================================================
+// EventManager Private Functions
+// =============================================================================
+
+// fills rows and ids with one net change per entity, sorted into batches
+void EventManager::_foldEvents() {
+    std::stable_sort(log.begin(), log.end(), [](const StructuralEvent& a, const StructuralEvent& b) {
+        return a.eID < b.eID;
+    });
+
+    rows.clear();
+    for (size_t beg = 0, end = 0; beg < log.size(); beg = end) {
+        EntityID eID = log[beg].eID;
+        end = beg + 1;
+        bool destroyed = (log[beg].type == StructuralEventType::DESTROYED);
+        while (end < log.size() && log[end].eID == eID) {
+            destroyed |= (log[end].type == StructuralEventType::DESTROYED);
+            end++;
+        }
+
+        // the first event tells the state at the previous flush
+        bool existed = (log[beg].type != StructuralEventType::CREATED);
+        const Archetype* from = existed ? log[beg].from : nullptr;
+
+        Chunk* chunk = nullptr;
+        ChunkIdx idx = CHUNK_IDX_NULL;
+        if (entityMgr.hasEntity(eID)) {
+            const Entity& entity = entityMgr.getEntity(eID);
+            chunk = &chunkMgr.getChunk(entity.getChunkID());
+            idx = entity.getChunkIdx();
+        }
+
+        if (existed && destroyed)
+            rows.push_back({StructuralEventType::DESTROYED, eID, nullptr, from, CHUNK_IDX_NULL});
+        if (chunk && (destroyed || !existed))
+            rows.push_back({StructuralEventType::CREATED, eID, chunk, nullptr, idx});
+        else if (chunk && chunk->getArchetype() != from)
+            rows.push_back({StructuralEventType::MOVED, eID, chunk, from, idx});
+    }
+
+    // IDs instead of pointers so batches come in a reproducible order
+    std::sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+        if (a.type != b.type) return a.type < b.type;
+        ChunkID ca = a.chunk ? a.chunk->getChunkID() : CHUNK_ID_NULL;
+        ChunkID cb = b.chunk ? b.chunk->getChunkID() : CHUNK_ID_NULL;
+        if (ca != cb) return ca < cb;
+        ArchetypeID fa = a.from ? a.from->getID() : ARCHETYPE_ID_NULL;
+        ArchetypeID fb = b.from ? b.from->getID() : ARCHETYPE_ID_NULL;
+        if (fa != fb) return fa < fb;
+        if (a.idx != b.idx) return a.idx < b.idx;
+        return a.eID < b.eID;
+    });
+
+    ids.resize(rows.size());
+    for (size_t i = 0; i < rows.size(); i++) ids[i] = rows[i].eID;
+}
+
+void EventManager::_dispatch(const ObserverBatch& batch) {
+    for (const Observer& observer : observers) {
+        if (!observer.fn) continue;
+
+        bool matches = false;
+        if (batch.from)  matches |= batch.from->getMask().contains(observer.mask);
+        if (batch.chunk) matches |= batch.chunk->getArchetype()->getMask().contains(observer.mask);
+        if (matches) observer.fn(batch);
+    }
+}
+
+} // namespace ECS
@@ -0,0 +1,464 @@
+#pragma once
+
+#include "ecs/types.hpp"
+#include "ecs/chunk.hpp"
+#include "ecs/chunk_list.hpp"
+#include "ecs/enable_mask.hpp"
+#include "utils/job_system.hpp"
+
+#include <algorithm> // for std::max
+#include <atomic>
+#include <tuple>
+#include <vector>
+
+namespace ECS {
+
+// =============================================================================
+// Query Terms
+//
+// Each type in Query<Ts...> is a term that adds filter bits to the query key
+// and contributes zero or one column pointers to the per chunk callback:
+//
+//   T              required component, yields T* (const T yields const T*)
+//   With<Ts...>    required components, yields nothing (useful for tags)
+//   Without<Ts...> excluded components, yields nothing
+//   Optional<T>    yields T* when the chunk has the component, else nullptr
+//   Changed<Ts...> required components, yields nothing, skips chunks where
+//                  none of these columns were written since the last run
+//   Shared<S>      required shared component, yields const S* to the single
+//                  value shared by every entity in the chunk
+//
+// Non-const columns are marked as written when a chunk is visited, so read
+// only access should be requested with const T.
+//
+// Rows whose enableable components are switched off are skipped: T, const T,
+// With<Ts...> and Changed<Ts...> visit rows where they are enabled, and
+// Without<Ts...> visits rows where they are disabled (or absent). Optional<T>
+// does not filter.
+// =============================================================================
+
+template <typename... Ts> struct With {};
+template <typename... Ts> struct Without {};
+template <typename T>     struct Optional {};
+template <typename... Ts> struct Changed {};
+template <typename S>     struct Shared {};
+
+struct QueryKey {
+    ArchetypeMask with;     // archetype must contain all of these components
+    ArchetypeMask without;  // archetype must contain none of these components
+    ArchetypeMask disabled; // enableable, rows must have these disabled (set by World::query)
+
+    bool operator==(const QueryKey& other) const {
+        return with == other.with && without == other.without && disabled == other.disabled;
+    }
+};
+
+struct QueryKeyHasher {
+    size_t operator()(const QueryKey& key) const {
+        size_t h1 = std::hash<ArchetypeMask>{}(key.with);
+        size_t h2 = std::hash<ArchetypeMask>{}(key.without) ^ (std::hash<ArchetypeMask>{}(key.disabled) << 1);
+        return h1 ^ (h2 + 0x9e3779b97f4a7c15ULL + (h1 << 6) + (h1 >> 2));
+    }
+};
+
+template <typename T>
+struct QueryTerm {
+    static constexpr bool IS_CHANGE_FILTER = false;
+    static void addToKey(QueryKey& key) {
+        key.with |= ArchetypeMask::bit(getComponentID<T>());
+    }
+    static bool hasChanged(const Chunk&, uint32_t) { return false; }
+    static std::tuple<T*> getColumns(Chunk& chunk, ChunkIdx row) {
+        return std::tuple<T*>(chunk.data<T>() + row);
+    }
+};
+
+template <typename... Ts>
+struct QueryTerm<With<Ts...>> {
+    static constexpr bool IS_CHANGE_FILTER = false;
+    static void addToKey(QueryKey& key) {
+        ((key.with |= ArchetypeMask::bit(getComponentID<Ts>())), ...);
+    }
+    static bool hasChanged(const Chunk&, uint32_t) { return false; }
+    static std::tuple<> getColumns(Chunk&, ChunkIdx) { return {}; }
+};
+
+template <typename... Ts>
+struct QueryTerm<Without<Ts...>> {
+    static constexpr bool IS_CHANGE_FILTER = false;
+    static void addToKey(QueryKey& key) {
+        ((key.without |= ArchetypeMask::bit(getComponentID<Ts>())), ...);
+    }
+    static bool hasChanged(const Chunk&, uint32_t) { return false; }
+    static std::tuple<> getColumns(Chunk&, ChunkIdx) { return {}; }
+};
+
+template <typename... Ts>
+struct QueryTerm<Changed<Ts...>> {
+    static constexpr bool IS_CHANGE_FILTER = true;
+    static void addToKey(QueryKey& key) {
+        ((key.with |= ArchetypeMask::bit(getComponentID<Ts>())), ...);
+    }
+    static bool hasChanged(const Chunk& chunk, uint32_t since) {
+        return ((chunk.getComponentVersion(getComponentID<Ts>()) > since) || ...);
+    }
+    static std::tuple<> getColumns(Chunk&, ChunkIdx) { return {}; }
+};
+
+template <typename T>
+struct QueryTerm<Optional<T>> {
+    static constexpr bool IS_CHANGE_FILTER = false;
+    static void addToKey(QueryKey&) {}
+    static bool hasChanged(const Chunk&, uint32_t) { return false; }
+    static std::tuple<T*> getColumns(Chunk& chunk, ChunkIdx row) {
+        return std::tuple<T*>(chunk.hasComponent<T>() ? chunk.data<T>() + row : nullptr);
+    }
+};
+
+template <typename S>
+struct QueryTerm<Shared<S>> {
+    static constexpr bool IS_CHANGE_FILTER = false;
+    static void addToKey(QueryKey& key) {
+        key.with |= ArchetypeMask::bit(getComponentID<S>());
+    }
+    static bool hasChanged(const Chunk&, uint32_t) { return false; }
+    static std::tuple<const S*> getColumns(Chunk& chunk, ChunkIdx) {
+        return std::tuple<const S*>(chunk.getShared<S>());
+    }
+};
+
+// =============================================================================
+// QueryCache
+//
+// The archetypes and chunk lists matching a QueryKey. Archetype masks are
+// tested once when an archetype or chunk list is created, never per frame.
+// =============================================================================
+
+class QueryCache {
+    friend class QueryManager;
+
+public:
+    QueryCache(QueryID id, QueryKey key);
+
+    bool matches(const ArchetypeMask& mask) const;
+
+    QueryID getID() const { return id; }
+    const QueryKey& getKey() const { return key; }
+    const std::vector<ArchetypeID>& getArchetypes() const { return archetypes; }
+    const std::vector<ChunkList*>&  getLists()      const { return lists; }
+
+private:
+    QueryID  id;
+    QueryKey key;
+    std::vector<ArchetypeID> archetypes; // matching archetypes
+    std::vector<ChunkList*>  lists;      // chunk lists of matching archetypes
+};
+
+QueryCache::QueryCache(QueryID id, QueryKey key)
+    : id(id),
+      key(key),
+      archetypes({}),
+      lists({}) {}
+
+bool QueryCache::matches(const ArchetypeMask& mask) const {
+    return mask.contains(key.with) && !mask.intersects(key.without);
+}
+
+// =============================================================================
+// Query
+//
+// Lightweight view over a QueryCache. Iteration walks the cached chunk lists
+// and calls fn(count, entityIDs, columns...) once per non-empty chunk, or once
+// per run of visited rows in chunks where enable bits filter some rows out.
+//
+// Every forEach() runs at a fresh world version so a query never reports its
+// own writes as changes. Keep the Query object alive between runs (e.g. as a
+// system member) for Changed<Ts...> to compare against the previous run:
+//
+//   auto q = world.query<Position, const Velocity, Without<Disabled>>();
+//   q.forEach([](ChunkIdx n, const EntityID* ids, Position* p, const Velocity* v) {
+//       for (ChunkIdx i = 0; i < n; i++) { ... }
+//   });
+//
+// A shared filter restricts iteration to the chunk lists holding one shared
+// component value, tested once per list without touching entity data:
+//
+//   q.setSharedFilter(world.getSharedComponentID(Faction{2}));
+//
+// =============================================================================
+
+template <typename... Ts>
+class Query {
+public:
+    Query(QueryCache& cache, std::atomic<uint32_t>& worldVersion)
+        : cache(&cache),
+          worldVersion(&worldVersion),
+          lastVersion(0),
+          sharedFilter(SHARED_COMPONENT_ID_NULL) {}
+
+    static QueryKey makeKey();
+    static constexpr bool HAS_CHANGE_FILTER = (QueryTerm<Ts>::IS_CHANGE_FILTER || ...);
+
+    template <typename Fn>
+    void forEach(Fn&& fn);
+    template <typename Fn>
+    void forEachChunk(Fn&& fn);
+    template <typename Fn>
+    void forEachChunkIn(const std::vector<ChunkList*>& lists, Fn&& fn);
+    template <typename Fn>
+    void parallelForEach(JobSystem& jobs, Fn&& fn);
+
+    // shared value filter (SHARED_COMPONENT_ID_NULL to match every value)
+    void setSharedFilter(SharedComponentID vID) { sharedFilter = vID; }
+    SharedComponentID getSharedFilter() const { return sharedFilter; }
+    bool matchesList(const ChunkList& list) const;
+    bool getRows(const Chunk& chunk, uint64_t* rows) const;
+
+    size_t getEntityCount() const;
+    QueryCache& getCache() { return *cache; }
+    uint32_t getLastVersion() const { return lastVersion; }
+
+private:
+    bool _hasChanged(const Chunk& chunk) const;
+    template <typename Fn>
+    void _forEachChunkInList(ChunkList& list, Fn& fn);
+    template <typename Fn>
+    void _visitRows(Chunk& chunk, Fn& fn);
+    template <typename Fn>
+    void _visitColumns(Chunk& chunk, Fn& fn);
+
+    QueryCache* cache;
+    std::atomic<uint32_t>* worldVersion;
+    uint32_t lastVersion; // world version of the previous forEach()
+    SharedComponentID sharedFilter;
+};
+
+template <typename... Ts>
+QueryKey Query<Ts...>::makeKey() {
+    QueryKey key{};
+    (QueryTerm<Ts>::addToKey(key), ...);
+    return key;
+}
+
+template <typename... Ts>
+template <typename Fn>
+void Query<Ts...>::forEach(Fn&& fn) {
+    uint32_t runVersion = worldVersion->fetch_add(1) + 1;
+
+    for (ChunkList* list : cache->getLists()) {
+        if (!matchesList(*list)) continue;
+        for (Chunk* chunk = list->getHeadChunk(); chunk; chunk = chunk->getNextChunk()) {
+            if (chunk->isEmpty()) continue;
+            if constexpr (HAS_CHANGE_FILTER) {
+                if (!_hasChanged(*chunk)) continue;
+            }
+            _visitRows(*chunk, fn);
+        }
+    }
+
+    // writes made after this run must compare newer than runVersion
+    lastVersion = runVersion;
+    worldVersion->fetch_add(1);
+}
+
+// Like forEach() but calls fn(count, columns...) without the EntityID column.
+// Column pointers of a whole chunk are CHUNK_COLUMN_ALIGNMENT aligned, but
+// runs left by enable bits start mid chunk and are only element aligned, so
+// kernels must use unaligned loads. The columns of a chunk never overlap so
+// kernels may declare them ECS_RESTRICT:
+//
+//   q.forEachChunk([](ChunkIdx n, Position* ECS_RESTRICT p, const Velocity* ECS_RESTRICT v) {
+//       ...
+//   });
+//
+template <typename... Ts>
+template <typename Fn>
+void Query<Ts...>::forEachChunk(Fn&& fn) {
+    uint32_t runVersion = worldVersion->fetch_add(1) + 1;
+
+    for (ChunkList* list : cache->getLists()) {
+        if (matchesList(*list))
+            _forEachChunkInList(*list, fn);
+    }
+
+    lastVersion = runVersion;
+    worldVersion->fetch_add(1);
+}
+
+// Like forEachChunk() but visits only the given lists, in the given order, so
+// a system can order its chunks (e.g. parents before children). Every list
+// must come from getCache().getLists().
+template <typename... Ts>
+template <typename Fn>
+void Query<Ts...>::forEachChunkIn(const std::vector<ChunkList*>& lists, Fn&& fn) {
+    uint32_t runVersion = worldVersion->fetch_add(1) + 1;
+
+    for (ChunkList* list : lists) {
+        if (matchesList(*list))
+            _forEachChunkInList(*list, fn);
+    }
+
+    lastVersion = runVersion;
+    worldVersion->fetch_add(1);
+}
+
+// Like forEach() but spreads the chunks over the JobSystem threads and returns
+// when every chunk was visited. Chunks are grouped into batches of about equal
+// entity count (chunks are rarely full), and each chunk is in exactly one
+// batch, so fn never sees a chunk on two threads at once. fn must only touch
+// the chunk it is given; reductions go through a PerThread:
+//
+//   PerThread<float> sums(world.getJobSystem(), 0.0f);
+//   q.parallelForEach(world.getJobSystem(), [&](ChunkIdx n, const EntityID* ids, const Health* h) {
+//       float& sum = sums.local();
+//       for (ChunkIdx i = 0; i < n; i++) sum += h[i].hp;
+//   });
+//
+template <typename... Ts>
+template <typename Fn>
+void Query<Ts...>::parallelForEach(JobSystem& jobs, Fn&& fn) {
+    uint32_t runVersion = worldVersion->fetch_add(1) + 1;
+
+    // change filters are tested here, before any column is marked written
+    std::vector<Chunk*> chunks;
+    size_t total = 0;
+    for (ChunkList* list : cache->getLists()) {
+        if (!matchesList(*list)) continue;
+        for (Chunk* chunk = list->getHeadChunk(); chunk; chunk = chunk->getNextChunk()) {
+            if (chunk->isEmpty()) continue;
+            if constexpr (HAS_CHANGE_FILTER) {
+                if (!_hasChanged(*chunk)) continue;
+            }
+            chunks.push_back(chunk);
+            total += chunk->getCount();
+        }
+    }
+
+    // batch boundaries, about 4 batches per thread so stealing can even out
+    // the rest (batch b is chunks [bounds[b], bounds[b + 1]))
+    size_t target = std::max<size_t>(1, total / (jobs.getThreadCount() * 4));
+    std::vector<size_t> bounds{0};
+    size_t filled = 0;
+    for (size_t c = 0; c < chunks.size(); c++) {
+        filled += chunks[c]->getCount();
+        if (filled >= target || c + 1 == chunks.size()) {
+            bounds.push_back(c + 1);
+            filled = 0;
+        }
+    }
+
+    jobs.parallelFor(0, bounds.size() - 1, [&](size_t beg, size_t end) {
+        for (size_t c = bounds[beg]; c < bounds[end]; c++) {
+            _visitRows(*chunks[c], fn);
+        }
+    });
+
+    lastVersion = runVersion;
+    worldVersion->fetch_add(1);
+}
+
+template <typename... Ts>
+bool Query<Ts...>::matchesList(const ChunkList& list) const {
+    return sharedFilter == SHARED_COMPONENT_ID_NULL || list.getSharedSet().contains(sharedFilter);
+}
+
+// Combines the enable masks the query filters on into rows (at least
+// CHUNK_ENABLE_WORDS_MAX words). Returns false, leaving rows untouched, when
+// every row is visited, the common case, which costs one SIMD full test per
+// mask and no copy.
+template <typename... Ts>
+bool Query<Ts...>::getRows(const Chunk& chunk, uint64_t* rows) const {
+    const Archetype& archetype = *chunk.getArchetype();
+    if (archetype.getEnableColumns().empty()) return false;
+
+    const QueryKey& key = cache->getKey();
+    ChunkIdx count = chunk.getCount();
+    size_t words = getEnableMaskWords(count);
+    bool filtered = false;
+
+    for (uint8_t column : archetype.getEnableColumns()) {
+        ComponentID cID = archetype.getComponents()[column].getID();
+        bool required = key.with.test(cID);
+        if (!required && !key.disabled.test(cID)) continue;
+
+        const uint64_t* bits = chunk.getEnableMask(cID);
+        if (required && isEnableMaskFull(bits, count)) continue;
+
+        for (size_t i = 0; i < words; i++) {
+            uint64_t word = required ? bits[i] : (~bits[i] & getEnableMaskValid(i, count));
+            rows[i] = filtered ? (rows[i] & word) : word;
+        }
+        filtered = true;
+    }
+    return filtered;
+}
+
+template <typename... Ts>
+template <typename Fn>
+void Query<Ts...>::_forEachChunkInList(ChunkList& list, Fn& fn) {
+    for (Chunk* chunk = list.getHeadChunk(); chunk; chunk = chunk->getNextChunk()) {
+        if (chunk->isEmpty()) continue;
+        if constexpr (HAS_CHANGE_FILTER) {
+            if (!_hasChanged(*chunk)) continue;
+        }
+        _visitColumns(*chunk, fn);
+    }
+}
+
+// calls fn(count, entityIDs, columns...) for the whole chunk or each run of
+// rows passing the enable filters
+template <typename... Ts>
+template <typename Fn>
+void Query<Ts...>::_visitRows(Chunk& chunk, Fn& fn) {
+    auto visit = [&](ChunkIdx beg, ChunkIdx end) {
+        std::apply(fn, std::tuple_cat(
+            std::make_tuple(static_cast<ChunkIdx>(end - beg), chunk.getEntityIDs() + beg),
+            QueryTerm<Ts>::getColumns(chunk, beg)...));
+    };
+
+    uint64_t rows[CHUNK_ENABLE_WORDS_MAX];
+    if (getRows(chunk, rows)) forEachEnabledRun(rows, chunk.getCount(), visit);
+    else                       visit(0, chunk.getCount());
+}
+
+// calls fn(count, columns...), columns are only element aligned for runs
+// that start inside the chunk
+template <typename... Ts>
+template <typename Fn>
+void Query<Ts...>::_visitColumns(Chunk& chunk, Fn& fn) {
+    uint64_t rows[CHUNK_ENABLE_WORDS_MAX];
+    if (getRows(chunk, rows)) {
+        forEachEnabledRun(rows, chunk.getCount(), [&](ChunkIdx beg, ChunkIdx end) {
+            std::apply([&](auto*... columns) {
+                fn(static_cast<ChunkIdx>(end - beg), columns...);
+            }, std::tuple_cat(QueryTerm<Ts>::getColumns(chunk, beg)...));
+        });
+        return;
+    }
+
+    ChunkIdx count = chunk.getCount();
+    std::apply([&](auto*... columns) {
+        fn(count, assumeColumnAligned(columns)...);
+    }, std::tuple_cat(QueryTerm<Ts>::getColumns(chunk, 0)...));
+}
+
+// true if any Changed<Ts...> column was written since the previous run
+template <typename... Ts>
+bool Query<Ts...>::_hasChanged(const Chunk& chunk) const {
+    return (QueryTerm<Ts>::hasChanged(chunk, lastVersion) || ...);
+}
+
+template <typename... Ts>
+size_t Query<Ts...>::getEntityCount() const {
+    size_t total = 0;
+    for (ChunkList* list : cache->getLists()) {
+        if (!matchesList(*list)) continue;
+        for (Chunk* chunk = list->getHeadChunk(); chunk; chunk = chunk->getNextChunk()) {
+            uint64_t rows[CHUNK_ENABLE_WORDS_MAX];
+            total += getRows(*chunk, rows) ? countEnabledRows(rows, chunk->getCount()) : chunk->getCount();
+        }
+    }
+    return total;
+}
+
+} // namespace ECS
\ No newline at end of file
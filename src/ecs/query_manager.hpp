@@ -0,0 +1,131 @@
+#pragma once
+
+#include "ecs/types.hpp"
+#include "ecs/archetype.hpp"
+#include "ecs/chunk_list.hpp"
+#include "ecs/query.hpp"
+#include "utils/assert.hpp"
+
+#include <deque>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+namespace ECS {
+
+// =============================================================================
+// QueryManager
+//
+// Owns every QueryCache in a World. The ArchetypeManager and ChunkManager
+// notify it when archetypes and chunk lists are created so that each cache is
+// updated incrementally instead of rescanning all archetypes per query.
+// =============================================================================
+
+class QueryManager {
+public:
+    QueryManager();
+
+    bool hasQuery(QueryID id) const;
+    QueryCache& getQuery(QueryID id);
+    QueryCache& getOrCreateQuery(const QueryKey& key);
+
+    // notifications
+    void onArchetypeCreated(const Archetype& archetype);
+    void onListCreated(ChunkList& list);
+
+    void print();
+
+private:
+    std::deque<QueryCache> queries;
+    std::unordered_map<QueryKey, QueryID, QueryKeyHasher> keyToIDs;
+
+    // every archetype and chunk list seen so far, used to fill new caches,
+    // with their masks packed side by side so a new query scans them with one
+    // SIMD subset and overlap test per mask
+    std::vector<const Archetype*> archetypes;
+    std::vector<ArchetypeMask> archetypeMasks;
+    std::vector<ChunkList*> lists;
+    std::vector<ArchetypeMask> listMasks;
+};
+
+// =============================================================================
+// QueryManager Functions
+// =============================================================================
+
+QueryManager::QueryManager()
+    : queries({}),
+      keyToIDs({}),
+      archetypes({}),
+      archetypeMasks({}),
+      lists({}),
+      listMasks({}) {}
+
+bool QueryManager::hasQuery(QueryID id) const {
+    return id < static_cast<QueryID>(queries.size());
+}
+
+QueryCache& QueryManager::getQuery(QueryID id) {
+    ASSERT(hasQuery(id), "QueryID " << id << " does not exist.");
+    return queries[id];
+}
+
+QueryCache& QueryManager::getOrCreateQuery(const QueryKey& key) {
+    ASSERT(!key.with.intersects(key.without),
+        "Query cannot both require and exclude a component.");
+
+    // if query already exists then return it
+    auto it = keyToIDs.find(key);
+    if (it != keyToIDs.end()) {
+        return queries[it->second];
+    }
+
+    // otherwise create new query and match it against existing archetypes
+    ASSERT(queries.size() < QUERY_ID_NULL, "Query registry full.");
+    QueryID id = static_cast<QueryID>(queries.size());
+    QueryCache& cache = queries.emplace_back(id, key);
+    keyToIDs.insert({key, id});
+
+    for (size_t i = 0; i < archetypeMasks.size(); i++) {
+        if (cache.matches(archetypeMasks[i]))
+            cache.archetypes.push_back(archetypes[i]->getID());
+    }
+
+    for (size_t i = 0; i < listMasks.size(); i++) {
+        if (cache.matches(listMasks[i]))
+            cache.lists.push_back(lists[i]);
+    }
+
+    return cache;
+}
+
+void QueryManager::onArchetypeCreated(const Archetype& archetype) {
+    archetypes.push_back(&archetype);
+    archetypeMasks.push_back(archetype.getMask());
+    for (QueryCache& cache : queries) {
+        if (cache.matches(archetype.getMask()))
+            cache.archetypes.push_back(archetype.getID());
+    }
+}
+
+void QueryManager::onListCreated(ChunkList& list) {
+    lists.push_back(&list);
+    listMasks.push_back(list.getKey().archetype);
+    for (QueryCache& cache : queries) {
+        if (cache.matches(list.getKey().archetype))
+            cache.lists.push_back(&list);
+    }
+}
+
+void QueryManager::print() {
+    std::cout << "queries:" << std::endl;
+    for (const QueryCache& q : queries) {
+        std::cout << "  - id: "         << q.getID()                << std::endl;
+        std::cout << "    with: "       << q.getKey().with          << std::endl;
+        std::cout << "    without: "    << q.getKey().without       << std::endl;
+        std::cout << "    disabled: "   << q.getKey().disabled      << std::endl;
+        std::cout << "    archetypes: " << q.getArchetypes().size() << std::endl;
+        std::cout << "    lists: "      << q.getLists().size()      << std::endl;
+    }
+}
+
+} // namespace ECS
\ No newline at end of file
@@ -0,0 +1,272 @@
+#pragma once
+
+#include "ecs/types.hpp"
+#include "utils/assert.hpp"
+
+#include <algorithm> // for std::sort
+#include <cstddef>   // for std::byte
+#include <cstring>   // for std::memcpy
+#include <deque>
+#include <iostream>
+#include <new>       // for std::align_val_t
+#include <stdexcept> // for std::runtime_error
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ECS {
+
+// =============================================================================
+// SharedSet
+//
+// The shared component values of every entity in a chunk list, sorted by
+// component ID. Entities with equal values share a chunk list, so a value is
+// read once per chunk instead of once per entity.
+// =============================================================================
+
+struct SharedSet {
+    SharedSetID id;
+    ArchetypeMask mask;                    // shared components in this set
+    std::vector<ComponentID> cIDs;         // sorted
+    std::vector<SharedComponentID> values; // value of cIDs[i]
+    std::vector<const void*> data;         // data of values[i]
+
+    bool contains(SharedComponentID vID) const;
+    const void* get(ComponentID cID) const;
+    SharedComponentID getValueID(ComponentID cID) const;
+};
+
+bool SharedSet::contains(SharedComponentID vID) const {
+    for (SharedComponentID v : values) {
+        if (v == vID) return true;
+    }
+    return false;
+}
+
+// returns nullptr if the set has no value for the component
+const void* SharedSet::get(ComponentID cID) const {
+    for (size_t i = 0; i < cIDs.size(); i++) {
+        if (cIDs[i] == cID) return data[i];
+    }
+    return nullptr;
+}
+
+SharedComponentID SharedSet::getValueID(ComponentID cID) const {
+    for (size_t i = 0; i < cIDs.size(); i++) {
+        if (cIDs[i] == cID) return values[i];
+    }
+    return SHARED_COMPONENT_ID_NULL;
+}
+
+// =============================================================================
+// SharedComponentManager
+//
+// Interns shared component values (compared bytewise, so shared components
+// should not contain padding) and the sets they are combined into. Values
+// and sets are never released and their addresses never change, so running
+// out of SharedComponentIDs throws std::runtime_error. Set 0 is the empty set.
+// =============================================================================
+
+class SharedComponentManager {
+public:
+    static constexpr size_t VALUE_ALIGNMENT = CHUNK_COLUMN_ALIGNMENT;
+
+    SharedComponentManager();
+    ~SharedComponentManager();
+
+    SharedComponentManager(const SharedComponentManager&) = delete;
+    SharedComponentManager& operator=(const SharedComponentManager&) = delete;
+
+    // values
+    template <typename S>
+    SharedComponentID getOrCreateValue(const S& value);
+    SharedComponentID getOrCreateValue(ComponentID cID, const void* data, size_t size);
+    template <typename S>
+    SharedComponentID findValue(const S& value) const;
+    bool hasValue(SharedComponentID vID) const;
+    ComponentID getValueComponent(SharedComponentID vID) const;
+    const void* getValueData(SharedComponentID vID) const;
+    size_t getValueSize(SharedComponentID vID) const;
+    size_t getValueCount() const { return values.size(); }
+
+    // sets
+    bool hasSet(SharedSetID sID) const;
+    const SharedSet& getSet(SharedSetID sID) const;
+    SharedSetID getOrCreateSet(std::vector<SharedComponentID> vIDs);
+    SharedSetID getSetWith(SharedSetID sID, SharedComponentID vID);
+    SharedSetID getSetWithout(SharedSetID sID, ComponentID cID);
+    size_t getSetCount() const { return sets.size(); }
+
+    void print();
+
+private:
+    struct Value {
+        ComponentID cID;
+        uint32_t size;
+        std::byte* data; // VALUE_ALIGNMENT aligned
+    };
+
+    static std::string _makeValueKey(ComponentID cID, const void* data, size_t size);
+
+    std::vector<Value> values;
+    std::unordered_map<std::string, SharedComponentID> valueKeys;
+    std::deque<SharedSet> sets;
+    std::unordered_map<std::string, SharedSetID> setKeys;
+};
+
+// =============================================================================
+// SharedComponentManager Functions
+// =============================================================================
+
+SharedComponentManager::SharedComponentManager()
+    : values({}),
+      valueKeys({}),
+      sets({}),
+      setKeys({}) {
+    getOrCreateSet({}); // SHARED_SET_ID_EMPTY
+}
+
+SharedComponentManager::~SharedComponentManager() {
+    for (Value& value : values) {
+        ::operator delete(value.data, std::align_val_t(VALUE_ALIGNMENT));
+    }
+}
+
+template <typename S>
+SharedComponentID SharedComponentManager::getOrCreateValue(const S& value) {
+    static_assert(alignof(S) <= VALUE_ALIGNMENT, "Shared component is over aligned.");
+    return getOrCreateValue(getComponentID<S>(), &value, sizeof(S));
+}
+
+SharedComponentID SharedComponentManager::getOrCreateValue(ComponentID cID, const void* data, size_t size) {
+    std::string key = _makeValueKey(cID, data, size);
+    auto it = valueKeys.find(key);
+    if (it != valueKeys.end()) {
+        return it->second;
+    }
+
+    // checked in every build, an overflowing ID would alias another value
+    if (values.size() >= SHARED_COMPONENT_ID_NULL) {
+        throw std::runtime_error("Error: Shared component value registry full.");
+    }
+    SharedComponentID vID = static_cast<SharedComponentID>(values.size());
+
+    std::byte* copy = static_cast<std::byte*>(::operator new(size, std::align_val_t(VALUE_ALIGNMENT)));
+    std::memcpy(copy, data, size);
+    values.push_back({cID, static_cast<uint32_t>(size), copy});
+    valueKeys.insert({std::move(key), vID});
+
+    return vID;
+}
+
+// returns SHARED_COMPONENT_ID_NULL if no entity ever used the value
+template <typename S>
+SharedComponentID SharedComponentManager::findValue(const S& value) const {
+    auto it = valueKeys.find(_makeValueKey(getComponentID<S>(), &value, sizeof(S)));
+    return (it != valueKeys.end()) ? it->second : SHARED_COMPONENT_ID_NULL;
+}
+
+bool SharedComponentManager::hasValue(SharedComponentID vID) const {
+    return vID < values.size();
+}
+
+ComponentID SharedComponentManager::getValueComponent(SharedComponentID vID) const {
+    ASSERT(hasValue(vID), "SharedComponentID " << vID << " does not exist.");
+    return values[vID].cID;
+}
+
+const void* SharedComponentManager::getValueData(SharedComponentID vID) const {
+    ASSERT(hasValue(vID), "SharedComponentID " << vID << " does not exist.");
+    return values[vID].data;
+}
+
+size_t SharedComponentManager::getValueSize(SharedComponentID vID) const {
+    ASSERT(hasValue(vID), "SharedComponentID " << vID << " does not exist.");
+    return values[vID].size;
+}
+
+bool SharedComponentManager::hasSet(SharedSetID sID) const {
+    return sID < sets.size();
+}
+
+const SharedSet& SharedComponentManager::getSet(SharedSetID sID) const {
+    ASSERT(hasSet(sID), "SharedSetID " << sID << " does not exist.");
+    return sets[sID];
+}
+
+// at most one value per component, duplicates are an error
+SharedSetID SharedComponentManager::getOrCreateSet(std::vector<SharedComponentID> vIDs) {
+    for (SharedComponentID vID : vIDs) {
+        ASSERT(hasValue(vID), "SharedComponentID " << vID << " does not exist.");
+    }
+    std::sort(vIDs.begin(), vIDs.end(), [&](SharedComponentID a, SharedComponentID b) {
+        return values[a].cID < values[b].cID;
+    });
+
+    std::string key(reinterpret_cast<const char*>(vIDs.data()), vIDs.size() * sizeof(SharedComponentID));
+    auto it = setKeys.find(key);
+    if (it != setKeys.end()) {
+        return it->second;
+    }
+
+    SharedSetID sID = static_cast<SharedSetID>(sets.size());
+    SharedSet& set = sets.emplace_back();
+    set.id = sID;
+    set.mask = {};
+    for (SharedComponentID vID : vIDs) {
+        const Value& value = values[vID];
+        ASSERT(!set.mask.test(value.cID), "Shared set has two values for one component.");
+        set.mask.set(value.cID);
+        set.cIDs.push_back(value.cID);
+        set.values.push_back(vID);
+        set.data.push_back(value.data);
+    }
+    setKeys.insert({std::move(key), sID});
+
+    return sID;
+}
+
+// the set with the value added, replacing any value of the same component
+SharedSetID SharedComponentManager::getSetWith(SharedSetID sID, SharedComponentID vID) {
+    ComponentID cID = getValueComponent(vID);
+    const SharedSet& set = getSet(sID);
+    if (set.getValueID(cID) == vID) return sID;
+
+    std::vector<SharedComponentID> vIDs;
+    for (size_t i = 0; i < set.cIDs.size(); i++) {
+        if (set.cIDs[i] != cID) vIDs.push_back(set.values[i]);
+    }
+    vIDs.push_back(vID);
+    return getOrCreateSet(std::move(vIDs));
+}
+
+// the set with the value of the component removed
+SharedSetID SharedComponentManager::getSetWithout(SharedSetID sID, ComponentID cID) {
+    const SharedSet& set = getSet(sID);
+    if (set.getValueID(cID) == SHARED_COMPONENT_ID_NULL) return sID;
+
+    std::vector<SharedComponentID> vIDs;
+    for (size_t i = 0; i < set.cIDs.size(); i++) {
+        if (set.cIDs[i] != cID) vIDs.push_back(set.values[i]);
+    }
+    return getOrCreateSet(std::move(vIDs));
+}
+
+void SharedComponentManager::print() {
+    std::cout << "shared sets:" << std::endl;
+    for (const SharedSet& set : sets) {
+        std::cout << "  - id: "     << set.id           << std::endl;
+        std::cout << "    mask: "   << set.mask         << std::endl;
+        std::cout << "    values: " << set.values.size() << std::endl;
+    }
+}
+
+// intern key: every byte of the component ID, then the value bytes
+std::string SharedComponentManager::_makeValueKey(ComponentID cID, const void* data, size_t size) {
+    std::string key(sizeof(cID) + size, '\0');
+    std::memcpy(&key[0], &cID, sizeof(cID));
+    std::memcpy(&key[sizeof(cID)], data, size);
+    return key;
+}
+
+} // namespace ECS
\ No newline at end of file
@@ -0,0 +1,786 @@
+#pragma once
+
+#include "ecs/types.hpp"
+#include "ecs/chunk.hpp"
+#include "ecs/chunk_allocator.hpp"
+#include "ecs/world.hpp"
+#include "utils/assert.hpp"
+
+#include <algorithm> // for std::sort
+#include <cstddef>   // for std::byte
+#include <cstdint>
+#include <cstring>   // for std::memcpy
+#include <fstream>
+#include <map>
+#include <new>       // for std::align_val_t
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__linux__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace ECS {
+
+// =============================================================================
+// Snapshot Format
+//
+// A snapshot stores the World tables followed by raw chunk images:
+//
+//   SnapshotHeader
+//   SnapshotComponent[componentCount]
+//   SnapshotArchetype[archetypeCount]
+//   SnapshotSharedValue[sharedValueCount] + value bytes
+//   per shared set: uint32 count, uint32 value index[count]
+//   SnapshotEntity[entityCount]            (FULL only)
+//   EntityID free[freeEntityCount]         (FULL only)
+//   EntityGeneration[entityCount]          (DELTA only)
+//   SnapshotChunk[chunkCount]
+//   ChunkID tombstone[tombstoneCount]      (DELTA only)
+//   padding up to chunkOffset (a multiple of CHUNK_MIN_SIZE)
+//   Chunk image[chunkCount], the size of its size class each
+//
+// A FULL snapshot holds every live chunk. A DELTA holds only the chunks
+// written since the snapshot it applies to, plus the IDs of the chunks freed
+// since then (tombstones). Its tables are complete since they are small and
+// only ever grow. Entity locations follow from the chunk images, but the
+// generation of every entity slot is kept so a merge does not hand out stale
+// (ID, generation) pairs again.
+//
+// Every record is padded to its alignment. Chunk images are written verbatim,
+// so their header pointers are stale and are rebuilt from the SnapshotChunk
+// records on load. Values are stored in native byte order, snapshots are not
+// portable between architectures.
+// =============================================================================
+
+constexpr const char     SNAPSHOT_MAGIC[8]       = {'R', 'T', 'S', 'S', 'N', 'A', 'P', '\0'};
+constexpr const uint32_t SNAPSHOT_FORMAT_VERSION = 7;
+
+enum class SnapshotKind : uint32_t {
+    FULL,
+    DELTA,
+};
+
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t formatVersion;
+    SnapshotKind kind;
+    uint32_t chunkMinSize;    // size of the smallest chunk size class
+    uint32_t chunkHeaderSize;
+    uint32_t componentCapacity; // bits per archetype mask (ECS_MAX_COMPONENTS)
+    uint32_t baseVersion;     // DELTA: world version of the snapshot it applies to
+    uint32_t worldVersion;    // world version when saved
+    uint32_t componentCount;
+    uint32_t archetypeCount;
+    uint32_t sharedValueCount;
+    uint32_t sharedSetCount;
+    uint32_t entityCount;     // entity table slots, alive or not
+    uint32_t freeEntityCount;
+    uint32_t chunkCount;      // chunk images in the file
+    uint32_t chunkTableSize;  // chunk IDs in use when saved (highest ID + 1)
+    uint32_t tombstoneCount;
+    uint64_t chunkOffset;     // file offset of the first chunk image
+};
+
+struct SnapshotComponent {
+    uint64_t typeHash; // see getTypeHash()
+    uint16_t id;
+    uint16_t size;
+    uint8_t  shared;
+    uint8_t  enableable; // chunk images then hold its enable masks
+    uint8_t  pad[2];
+};
+
+struct SnapshotArchetype {
+    ArchetypeMask mask; // componentCapacity bits
+    uint16_t capacity[CHUNK_SIZE_CLASS_COUNT]; // per size class
+    uint8_t  sizeClass; // class of new chunks
+    uint8_t  sizeHint;  // AUTO unless pinned
+};
+
+struct SnapshotSharedValue {
+    uint16_t cID;
+    uint16_t pad;
+    uint32_t size;
+};
+
+struct SnapshotEntity {
+    uint32_t id;
+    uint32_t chunkID;
+    uint16_t chunkIdx;
+    uint16_t pad;
+    uint32_t generation;
+};
+
+struct SnapshotChunk {
+    uint32_t chunkID;
+    uint32_t groupID;
+    uint32_t sharedSetID; // index of the saved shared set
+    uint16_t archetypeID; // index of the saved archetype
+    uint16_t count;
+    uint8_t  sizeClass;
+    uint8_t  pad[3];
+};
+
+// =============================================================================
+// Snapshot
+//
+// Saves a World to a file and loads it back by adopting the chunk images in
+// place. On POSIX systems the file is mapped copy-on-write, so loading reads
+// only the pages that are touched and never decodes entities one by one.
+// Elsewhere the file is read into one aligned allocation.
+//
+// The loading World must be freshly constructed, with the same components
+// registered (same IDs, types, sizes and shared flags) as the saved World.
+// Listing the components with ECS_COMPONENT_ID keeps their IDs stable across
+// builds and runs.
+//
+//   Snapshot::save(world, "save.snap");
+//   ECS::World loaded;
+//   registerComponents(loaded);
+//   Snapshot::load(loaded, "save.snap");
+//
+// Deltas written by an Autosave are folded into their base offline with
+// merge(), which writes a new FULL snapshot.
+//
+// Errors are reported by throwing std::runtime_error, after which the World
+// should be discarded.
+// =============================================================================
+
+class Snapshot {
+    friend class Autosave;
+
+public:
+    static uint64_t save(World& world, const std::string& path);
+    static void load(World& world, const std::string& path);
+    static void merge(const std::string& basePath, const std::vector<std::string>& deltaPaths, const std::string& outPath);
+
+private:
+    // a file loaded in memory, owned by the ChunkAllocator once adopted
+    struct Image {
+        std::byte* base;
+        size_t size;
+        ChunkAllocator::RegionType type;
+    };
+
+    // decoded snapshot, chunk images point into a World or an Image
+    struct Tables {
+        SnapshotKind kind;
+        uint32_t baseVersion;
+        uint32_t worldVersion;
+        uint32_t entityCount;
+        uint32_t chunkTableSize;
+        std::vector<SnapshotComponent> components;
+        std::vector<SnapshotArchetype> archetypes;
+        std::vector<SnapshotSharedValue> values;
+        std::vector<const std::byte*> valueData;
+        std::vector<std::vector<uint32_t>> sets;
+        std::vector<SnapshotEntity> entities;
+        std::vector<EntityID> freeIDs;
+        std::vector<EntityGeneration> generations; // DELTA, per entity slot
+        std::vector<SnapshotChunk> chunks;
+        std::vector<const void*> images; // image of chunks[i]
+        std::vector<ChunkID> tombstones;
+    };
+
+    static Tables _collect(World& world, SnapshotKind kind, uint32_t baseVersion);
+    static uint64_t _write(const Tables& tables, const std::string& path);
+    static Tables _parse(const Image& image, const std::string& path);
+    static void _apply(World& world, const Tables& tables, const std::string& path);
+    static void _rebuildEntities(Tables& tables);
+
+    static Image _openImage(const std::string& path);
+    static void  _closeImage(Image& image);
+
+    template <typename T>
+    static void _put(std::vector<std::byte>& out, const T& value);
+    template <typename T>
+    static const T* _get(const Image& image, size_t& cursor, size_t count = 1);
+};
+
+// =============================================================================
+// Snapshot Functions
+// =============================================================================
+
+// returns the number of bytes written
+uint64_t Snapshot::save(World& world, const std::string& path) {
+    return _write(_collect(world, SnapshotKind::FULL, 0), path);
+}
+
+void Snapshot::load(World& world, const std::string& path) {
+    ASSERT(world.chunkMgr.chunks.empty() && world.entityMgr.getCapacity() == 0,
+        "Snapshots can only be loaded into an empty World.");
+
+    Image image = _openImage(path);
+
+    try {
+        Tables tables = _parse(image, path);
+        if (tables.kind != SnapshotKind::FULL) {
+            throw std::runtime_error("Error: Delta snapshots must be merged before loading: " + path);
+        }
+        _apply(world, tables, path);
+    }
+    catch (...) {
+        _closeImage(image);
+        throw;
+    }
+
+    world.chunkMgr.chunkAllocator.adoptRegion(image.base, image.size, image.type);
+}
+
+// applies the deltas in order to the base snapshot and writes the result as a
+// FULL snapshot, each delta must apply to the snapshot before it
+void Snapshot::merge(const std::string& basePath, const std::vector<std::string>& deltaPaths, const std::string& outPath) {
+    std::vector<Image> images;
+
+    try {
+        images.push_back(_openImage(basePath));
+        Tables merged = _parse(images.back(), basePath);
+        if (merged.kind != SnapshotKind::FULL) {
+            throw std::runtime_error("Error: Merge base is not a full snapshot: " + basePath);
+        }
+
+        // chunk ID -> (record, image)
+        std::map<ChunkID, std::pair<SnapshotChunk, const void*>> chunks;
+        for (size_t i = 0; i < merged.chunks.size(); i++) {
+            chunks[merged.chunks[i].chunkID] = {merged.chunks[i], merged.images[i]};
+        }
+
+        for (const std::string& deltaPath : deltaPaths) {
+            images.push_back(_openImage(deltaPath));
+            Tables delta = _parse(images.back(), deltaPath);
+            if (delta.kind != SnapshotKind::DELTA || delta.baseVersion != merged.worldVersion) {
+                throw std::runtime_error("Error: Delta does not apply to the merged snapshot: " + deltaPath);
+            }
+
+            for (ChunkID cID : delta.tombstones) {
+                chunks.erase(cID);
+            }
+            for (size_t i = 0; i < delta.chunks.size(); i++) {
+                chunks[delta.chunks[i].chunkID] = {delta.chunks[i], delta.images[i]};
+            }
+
+            // tables only grow, so the newest ones index every older record
+            delta.chunks.clear();
+            delta.images.clear();
+            delta.tombstones.clear();
+            merged = std::move(delta);
+        }
+
+        merged.kind = SnapshotKind::FULL;
+        merged.baseVersion = 0;
+        merged.chunks.clear();
+        merged.images.clear();
+        for (const auto& [cID, chunk] : chunks) {
+            merged.chunks.push_back(chunk.first);
+            merged.images.push_back(chunk.second);
+        }
+        _rebuildEntities(merged);
+
+        _write(merged, outPath);
+    }
+    catch (...) {
+        for (Image& image : images) _closeImage(image);
+        throw;
+    }
+
+    for (Image& image : images) _closeImage(image);
+}
+
+// =============================================================================
+// Snapshot Private Functions
+// =============================================================================
+
+// a DELTA keeps only the chunks written after baseVersion, the caller fills in
+// the tombstones
+Snapshot::Tables Snapshot::_collect(World& world, SnapshotKind kind, uint32_t baseVersion) {
+    ComponentManager& componentMgr = world.componentMgr;
+    ArchetypeManager& archetypeMgr = world.archetypeMgr;
+    SharedComponentManager& sharedMgr = world.sharedMgr;
+    EntityManager& entityMgr = world.entityMgr;
+    ChunkManager& chunkMgr = world.chunkMgr;
+
+    Tables t;
+    t.kind           = kind;
+    t.baseVersion    = baseVersion;
+    t.worldVersion   = chunkMgr.getVersion();
+    t.entityCount    = static_cast<uint32_t>(entityMgr.getCapacity());
+    t.chunkTableSize = static_cast<uint32_t>(chunkMgr.chunks.size());
+
+    for (size_t id = 0; id < COMPONENT_CAPACITY; id++) {
+        ComponentID cID = static_cast<ComponentID>(id);
+        if (!componentMgr.hasComponent(cID)) continue;
+        Component c = componentMgr.getComponent(cID);
+        t.components.push_back({ComponentRegistry::getTypeHash(cID), cID, c.getSize(), uint8_t(c.isShared()), uint8_t(c.isEnableable()), {0, 0}});
+    }
+
+    for (size_t i = 0; i < archetypeMgr.getArchetypeCount(); i++) {
+        Archetype& a = archetypeMgr.getArchetype(static_cast<ArchetypeID>(i));
+        SnapshotArchetype rec{a.getMask(), {}, uint8_t(a.getSizeClass()), uint8_t(a.getSizeHint())};
+        for (size_t c = 0; c < CHUNK_SIZE_CLASS_COUNT; c++) {
+            rec.capacity[c] = a.getCapacity(ChunkSizeClass(c));
+        }
+        t.archetypes.push_back(rec);
+    }
+
+    for (size_t i = 0; i < sharedMgr.getValueCount(); i++) {
+        SharedComponentID vID = static_cast<SharedComponentID>(i);
+        uint32_t size = static_cast<uint32_t>(sharedMgr.getValueSize(vID));
+        t.values.push_back({sharedMgr.getValueComponent(vID), 0, size});
+        t.valueData.push_back(static_cast<const std::byte*>(sharedMgr.getValueData(vID)));
+    }
+
+    for (size_t i = 0; i < sharedMgr.getSetCount(); i++) {
+        const SharedSet& set = sharedMgr.getSet(static_cast<SharedSetID>(i));
+        t.sets.emplace_back(set.values.begin(), set.values.end());
+    }
+
+    if (kind == SnapshotKind::FULL) {
+        for (const Entity& e : entityMgr.entities) {
+            t.entities.push_back({e.getID(), e.getChunkID(), e.getChunkIdx(), 0, e.getGeneration()});
+        }
+        t.freeIDs = entityMgr.freeIDs;
+    } else {
+        for (const Entity& e : entityMgr.entities) {
+            t.generations.push_back(e.getGeneration());
+        }
+    }
+
+    for (const Chunk* chunk : chunkMgr.chunks) {
+        if (chunk->getChunkID() == CHUNK_ID_NULL || chunk->isEmpty()) continue;
+        if (kind == SnapshotKind::DELTA && chunk->getLatestVersion() <= baseVersion) continue;
+
+        t.chunks.push_back({
+            chunk->getChunkID(),
+            chunk->getGroupID(),
+            chunk->getSharedSetID(),
+            chunk->getArchetype()->getID(),
+            chunk->getCount(),
+            uint8_t(chunk->getSizeClass()),
+            {0, 0, 0}});
+        t.images.push_back(chunk);
+    }
+
+    return t;
+}
+
+// returns the number of bytes written
+uint64_t Snapshot::_write(const Tables& t, const std::string& path) {
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.formatVersion     = SNAPSHOT_FORMAT_VERSION;
+    header.kind              = t.kind;
+    header.chunkMinSize      = CHUNK_MIN_SIZE;
+    header.chunkHeaderSize   = CHUNK_HEADER_SIZE;
+    header.componentCapacity = COMPONENT_CAPACITY;
+    header.baseVersion       = t.baseVersion;
+    header.worldVersion      = t.worldVersion;
+    header.componentCount    = static_cast<uint32_t>(t.components.size());
+    header.archetypeCount    = static_cast<uint32_t>(t.archetypes.size());
+    header.sharedValueCount  = static_cast<uint32_t>(t.values.size());
+    header.sharedSetCount    = static_cast<uint32_t>(t.sets.size());
+    header.entityCount       = t.entityCount;
+    header.freeEntityCount   = static_cast<uint32_t>(t.freeIDs.size());
+    header.chunkCount        = static_cast<uint32_t>(t.chunks.size());
+    header.chunkTableSize    = t.chunkTableSize;
+    header.tombstoneCount    = static_cast<uint32_t>(t.tombstones.size());
+
+    std::vector<std::byte> out;
+    _put(out, header);
+
+    for (const SnapshotComponent& c : t.components) _put(out, c);
+    for (const SnapshotArchetype& a : t.archetypes) _put(out, a);
+
+    for (size_t i = 0; i < t.values.size(); i++) {
+        _put(out, t.values[i]);
+        out.insert(out.end(), t.valueData[i], t.valueData[i] + t.values[i].size);
+    }
+
+    for (const std::vector<uint32_t>& set : t.sets) {
+        _put(out, static_cast<uint32_t>(set.size()));
+        for (uint32_t v : set) _put(out, v);
+    }
+
+    if (t.kind == SnapshotKind::FULL) {
+        for (const SnapshotEntity& e : t.entities) _put(out, e);
+        for (EntityID id : t.freeIDs) _put(out, id);
+    } else {
+        for (EntityGeneration g : t.generations) _put(out, g);
+    }
+
+    for (const SnapshotChunk& c : t.chunks) _put(out, c);
+    for (ChunkID cID : t.tombstones) _put(out, cID);
+
+    uint64_t chunkOffset = (out.size() + CHUNK_MIN_SIZE - 1) / CHUNK_MIN_SIZE * CHUNK_MIN_SIZE;
+    reinterpret_cast<SnapshotHeader*>(out.data())->chunkOffset = chunkOffset;
+    out.resize(chunkOffset, std::byte(0));
+
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Error: Could not open snapshot file: " + path);
+    }
+
+    // images are multiples of CHUNK_MIN_SIZE, so each one stays aligned
+    uint64_t chunkBytes = 0;
+    file.write(reinterpret_cast<const char*>(out.data()), out.size());
+    for (size_t i = 0; i < t.images.size(); i++) {
+        size_t size = getChunkSize(ChunkSizeClass(t.chunks[i].sizeClass));
+        file.write(static_cast<const char*>(t.images[i]), size);
+        chunkBytes += size;
+    }
+
+    if (!file.good()) {
+        throw std::runtime_error("Error: Could not write snapshot file: " + path);
+    }
+
+    return chunkOffset + chunkBytes;
+}
+
+Snapshot::Tables Snapshot::_parse(const Image& image, const std::string& path) {
+    size_t cursor = 0;
+    const SnapshotHeader& header = *_get<SnapshotHeader>(image, cursor);
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 ||
+        header.formatVersion   != SNAPSHOT_FORMAT_VERSION ||
+        header.chunkMinSize    != CHUNK_MIN_SIZE ||
+        header.chunkHeaderSize != CHUNK_HEADER_SIZE ||
+        header.componentCapacity != COMPONENT_CAPACITY) {
+        throw std::runtime_error("Error: Incompatible snapshot file: " + path);
+    }
+
+    Tables t;
+    t.kind           = header.kind;
+    t.baseVersion    = header.baseVersion;
+    t.worldVersion   = header.worldVersion;
+    t.entityCount    = header.entityCount;
+    t.chunkTableSize = header.chunkTableSize;
+
+    const SnapshotComponent* components = _get<SnapshotComponent>(image, cursor, header.componentCount);
+    t.components.assign(components, components + header.componentCount);
+
+    const SnapshotArchetype* archetypes = _get<SnapshotArchetype>(image, cursor, header.archetypeCount);
+    t.archetypes.assign(archetypes, archetypes + header.archetypeCount);
+
+    for (uint32_t i = 0; i < header.sharedValueCount; i++) {
+        const SnapshotSharedValue& value = *_get<SnapshotSharedValue>(image, cursor);
+        if (value.cID >= COMPONENT_CAPACITY)
+            throw std::runtime_error("Error: Corrupt snapshot file: " + path);
+        t.values.push_back(value);
+        t.valueData.push_back(_get<std::byte>(image, cursor, value.size));
+    }
+
+    for (uint32_t i = 0; i < header.sharedSetCount; i++) {
+        uint32_t count = *_get<uint32_t>(image, cursor);
+        const uint32_t* indices = _get<uint32_t>(image, cursor, count);
+        for (uint32_t v = 0; v < count; v++) {
+            if (indices[v] >= header.sharedValueCount)
+                throw std::runtime_error("Error: Corrupt snapshot file: " + path);
+        }
+        t.sets.emplace_back(indices, indices + count);
+    }
+
+    if (header.kind == SnapshotKind::FULL) {
+        const SnapshotEntity* entities = _get<SnapshotEntity>(image, cursor, header.entityCount);
+        t.entities.assign(entities, entities + header.entityCount);
+        const EntityID* freeIDs = _get<EntityID>(image, cursor, header.freeEntityCount);
+        t.freeIDs.assign(freeIDs, freeIDs + header.freeEntityCount);
+    } else {
+        const EntityGeneration* generations = _get<EntityGeneration>(image, cursor, header.entityCount);
+        t.generations.assign(generations, generations + header.entityCount);
+    }
+
+    const SnapshotChunk* chunks = _get<SnapshotChunk>(image, cursor, header.chunkCount);
+    t.chunks.assign(chunks, chunks + header.chunkCount);
+
+    const ChunkID* tombstones = _get<ChunkID>(image, cursor, header.tombstoneCount);
+    t.tombstones.assign(tombstones, tombstones + header.tombstoneCount);
+
+    if (header.chunkOffset % CHUNK_MIN_SIZE != 0 || header.chunkOffset < cursor) {
+        throw std::runtime_error("Error: Corrupt snapshot file: " + path);
+    }
+
+    for (const SnapshotArchetype& a : t.archetypes) {
+        if (a.sizeClass >= CHUNK_SIZE_CLASS_COUNT ||
+            (a.sizeHint >= CHUNK_SIZE_CLASS_COUNT && a.sizeHint != uint8_t(ChunkSizeClass::AUTO))) {
+            throw std::runtime_error("Error: Corrupt snapshot file: " + path);
+        }
+    }
+
+    uint64_t offset = header.chunkOffset;
+    for (uint32_t i = 0; i < header.chunkCount; i++) {
+        const SnapshotChunk& c = t.chunks[i];
+        if (c.archetypeID >= t.archetypes.size() || c.sharedSetID >= t.sets.size() ||
+            c.chunkID >= t.chunkTableSize || c.count == 0 || c.sizeClass >= CHUNK_SIZE_CLASS_COUNT ||
+            c.count > t.archetypes[c.archetypeID].capacity[c.sizeClass]) {
+            throw std::runtime_error("Error: Corrupt snapshot file: " + path);
+        }
+
+        uint64_t size = getChunkSize(ChunkSizeClass(c.sizeClass));
+        if (offset + size > image.size) {
+            throw std::runtime_error("Error: Corrupt snapshot file: " + path);
+        }
+        t.images.push_back(image.base + offset);
+        offset += size;
+    }
+
+    return t;
+}
+
+void Snapshot::_apply(World& world, const Tables& t, const std::string& path) {
+    // components must match the registry of the loading world
+    for (const SnapshotComponent& c : t.components) {
+        if (c.id >= COMPONENT_CAPACITY || !world.componentMgr.hasComponent(c.id) ||
+            ComponentRegistry::getTypeHash(c.id) != c.typeHash ||
+            world.componentMgr.getComponent(c.id).isShared() != bool(c.shared) ||
+            world.componentMgr.getComponent(c.id).isEnableable() != bool(c.enableable) ||
+            world.componentMgr.getComponent(c.id).getSize() != c.size) {
+            throw std::runtime_error("Error: Snapshot component " + std::to_string(c.id) + " does not match the World: " + path);
+        }
+    }
+
+    // archetype layouts follow from the mask, so saved IDs map by mask
+    std::vector<Archetype*> archetypes;
+    for (const SnapshotArchetype& rec : t.archetypes) {
+        ArchetypeID aID = world.archetypeMgr.getOrCreateArchetype(rec.mask);
+        Archetype& archetype = world.archetypeMgr.getArchetype(aID);
+        archetypes.push_back(&archetype);
+        for (size_t c = 0; c < CHUNK_SIZE_CLASS_COUNT; c++) {
+            if (archetype.getCapacity(ChunkSizeClass(c)) != rec.capacity[c]) {
+                throw std::runtime_error("Error: Snapshot archetype layout does not match the World: " + path);
+            }
+        }
+        if (archetype.getCapacity(ChunkSizeClass(rec.sizeClass)) == 0) {
+            throw std::runtime_error("Error: Corrupt snapshot file: " + path);
+        }
+
+        // the size class is carried over so a large population keeps its
+        // large chunks
+        archetype.sizeClass = ChunkSizeClass(rec.sizeClass);
+        archetype.pinned = (rec.sizeHint != uint8_t(ChunkSizeClass::AUTO));
+    }
+
+    // shared values and sets are interned again
+    std::vector<SharedComponentID> values;
+    for (size_t i = 0; i < t.values.size(); i++) {
+        values.push_back(world.sharedMgr.getOrCreateValue(t.values[i].cID, t.valueData[i], t.values[i].size));
+    }
+
+    std::vector<SharedSetID> sets;
+    for (const std::vector<uint32_t>& set : t.sets) {
+        std::vector<SharedComponentID> vIDs;
+        for (uint32_t v : set) vIDs.push_back(values[v]);
+        sets.push_back(world.sharedMgr.getOrCreateSet(std::move(vIDs)));
+    }
+
+    // entity table
+    for (size_t i = 0; i < t.entities.size(); i++) {
+        const SnapshotEntity& e = t.entities[i];
+        if (e.id != ENTITY_ID_NULL)
+            world.entityMgr._restoreEntity(e.id, e.chunkID, e.chunkIdx);
+        world.entityMgr._restoreGeneration(static_cast<EntityID>(i), e.generation);
+    }
+    if (world.entityMgr.entities.size() < t.entityCount)
+        world.entityMgr.entities.resize(t.entityCount);
+    world.entityMgr.freeIDs = t.freeIDs;
+
+    // adopt chunk images in place, only the headers are rewritten
+    world.chunkMgr._beginAdoption(t.chunkTableSize);
+    for (size_t i = 0; i < t.chunks.size(); i++) {
+        const SnapshotChunk& c = t.chunks[i];
+        world.chunkMgr._adoptChunk(const_cast<void*>(t.images[i]), c.chunkID,
+            *archetypes[c.archetypeID], c.groupID, sets[c.sharedSetID], ChunkSizeClass(c.sizeClass), c.count);
+    }
+    world.chunkMgr._endAdoption();
+
+    // column versions in the images must compare older than future writes
+    if (world.chunkMgr.version < t.worldVersion)
+        world.chunkMgr.version = t.worldVersion;
+}
+
+// rebuilds the entity table from the entity ID column of every chunk and the
+// generations of the newest delta (or of the base when there is none), free
+// IDs are listed so that the lowest is reused first
+void Snapshot::_rebuildEntities(Tables& t) {
+    std::vector<EntityGeneration> generations = t.generations;
+    if (generations.empty()) {
+        for (const SnapshotEntity& e : t.entities) generations.push_back(e.generation);
+    }
+    generations.resize(t.entityCount, 0);
+
+    t.entities.assign(t.entityCount, {ENTITY_ID_NULL, CHUNK_ID_NULL, CHUNK_IDX_NULL, 0, 0});
+    for (size_t i = 0; i < t.entityCount; i++) t.entities[i].generation = generations[i];
+    t.generations.clear();
+
+    for (size_t i = 0; i < t.chunks.size(); i++) {
+        const SnapshotChunk& c = t.chunks[i];
+        const EntityID* ids = reinterpret_cast<const EntityID*>(
+            static_cast<const std::byte*>(t.images[i]) + CHUNK_HEADER_SIZE);
+        for (ChunkIdx row = 0; row < c.count; row++) {
+            if (ids[row] >= t.entityCount)
+                throw std::runtime_error("Error: Corrupt snapshot chunk " + std::to_string(c.chunkID));
+            t.entities[ids[row]] = {ids[row], c.chunkID, row, 0, generations[ids[row]]};
+        }
+    }
+
+    t.freeIDs.clear();
+    for (EntityID id = t.entityCount; id-- > 0;) {
+        if (t.entities[id].id == ENTITY_ID_NULL) t.freeIDs.push_back(id);
+    }
+}
+
+Snapshot::Image Snapshot::_openImage(const std::string& path) {
+#if defined(__linux__) || defined(__APPLE__)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Error: Could not open snapshot file: " + path);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        throw std::runtime_error("Error: Could not read snapshot file: " + path);
+    }
+
+    // private mapping: header fix-ups and later writes stay in memory
+    size_t size = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        throw std::runtime_error("Error: Could not map snapshot file: " + path);
+    }
+
+    return {static_cast<std::byte*>(base), size, ChunkAllocator::RegionType::MAPPED};
+#else
+    std::ifstream file(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Error: Could not open snapshot file: " + path);
+    }
+
+    size_t size = static_cast<size_t>(file.tellg());
+    void* base = ::operator new(size, std::align_val_t(CHUNK_MIN_SIZE));
+    file.seekg(0);
+    file.read(static_cast<char*>(base), size);
+    if (!file.good()) {
+        ::operator delete(base, std::align_val_t(CHUNK_MIN_SIZE));
+        throw std::runtime_error("Error: Could not read snapshot file: " + path);
+    }
+
+    return {static_cast<std::byte*>(base), size, ChunkAllocator::RegionType::HEAP};
+#endif
+}
+
+void Snapshot::_closeImage(Image& image) {
+    if (!image.base) return;
+    if (image.type == ChunkAllocator::RegionType::HEAP) {
+        ::operator delete(image.base, std::align_val_t(CHUNK_MIN_SIZE));
+    }
+#if defined(__linux__) || defined(__APPLE__)
+    else {
+        munmap(image.base, image.size);
+    }
+#endif
+    image.base = nullptr;
+}
+
+template <typename T>
+void Snapshot::_put(std::vector<std::byte>& out, const T& value) {
+    out.resize((out.size() + alignof(T) - 1) / alignof(T) * alignof(T), std::byte(0));
+    const std::byte* bytes = reinterpret_cast<const std::byte*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(T));
+}
+
+// returns count records at the cursor and advances it, throws if truncated
+template <typename T>
+const T* Snapshot::_get(const Image& image, size_t& cursor, size_t count) {
+    cursor = (cursor + alignof(T) - 1) / alignof(T) * alignof(T);
+    if (cursor + sizeof(T) * count > image.size) {
+        throw std::runtime_error("Error: Truncated snapshot file.");
+    }
+    const T* records = reinterpret_cast<const T*>(image.base + cursor);
+    cursor += sizeof(T) * count;
+    return records;
+}
+
+// =============================================================================
+// Autosave
+//
+// Writes a FULL snapshot once, then DELTA snapshots holding only the chunks
+// whose structure or columns were written since the previous save (compared
+// against chunk versions) and tombstones for the chunks freed since then.
+//
+//   Autosave autosave;
+//   autosave.saveBase(world, "save.base");
+//   autosave.saveDelta(world, "save.delta1"); // e.g. every 60 seconds
+//   Snapshot::merge("save.base", {"save.delta1"}, "save.snap"); // offline
+//
+// NOTE: mutable column access marks a column written even if it was only read
+//       (see Chunk::data()), so systems should request read only columns as
+//       const T to keep deltas small.
+// =============================================================================
+
+struct AutosaveStats {
+    uint32_t chunksWritten;
+    uint32_t tombstones;
+    uint64_t bytesWritten;
+};
+
+class Autosave {
+public:
+    Autosave() : lastVersion(0), lastLive({}), hasBase(false) {}
+
+    AutosaveStats saveBase(World& world, const std::string& path);
+    AutosaveStats saveDelta(World& world, const std::string& path);
+
+private:
+    void _advance(World& world);
+
+    uint32_t lastVersion;        // world version of the previous save
+    std::vector<bool> lastLive;  // chunk IDs live at the previous save
+    bool hasBase;
+};
+
+// =============================================================================
+// Autosave Functions
+// =============================================================================
+
+AutosaveStats Autosave::saveBase(World& world, const std::string& path) {
+    Snapshot::Tables tables = Snapshot::_collect(world, SnapshotKind::FULL, 0);
+    uint64_t bytes = Snapshot::_write(tables, path);
+    _advance(world);
+    hasBase = true;
+    return {static_cast<uint32_t>(tables.chunks.size()), 0, bytes};
+}
+
+AutosaveStats Autosave::saveDelta(World& world, const std::string& path) {
+    ASSERT(hasBase, "Autosave needs a base snapshot before saving deltas.");
+
+    Snapshot::Tables tables = Snapshot::_collect(world, SnapshotKind::DELTA, lastVersion);
+    const std::vector<Chunk*>& chunks = world.chunkMgr.chunks;
+    for (ChunkID cID = 0; cID < lastLive.size(); cID++) {
+        if (!lastLive[cID]) continue;
+        if (cID >= chunks.size() || chunks[cID]->getChunkID() == CHUNK_ID_NULL || chunks[cID]->isEmpty())
+            tables.tombstones.push_back(cID);
+    }
+
+    uint64_t bytes = Snapshot::_write(tables, path);
+    _advance(world);
+    return {static_cast<uint32_t>(tables.chunks.size()), static_cast<uint32_t>(tables.tombstones.size()), bytes};
+}
+
+// remembers the live chunks and moves the world version past the save so
+// that later writes compare newer
+void Autosave::_advance(World& world) {
+    const std::vector<Chunk*>& chunks = world.chunkMgr.chunks;
+    lastLive.assign(chunks.size(), false);
+    for (const Chunk* chunk : chunks) {
+        if (chunk->getChunkID() != CHUNK_ID_NULL && !chunk->isEmpty())
+            lastLive[chunk->getChunkID()] = true;
+    }
+
+    lastVersion = world.chunkMgr.version++;
+}
+
+} // namespace ECS
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "ecs/types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ECS {
+
+// =============================================================================
+// Stats
+//
+// Occupancy and churn figures sampled from a World with World::sampleStats().
+// Sampling walks the chunk headers once and reuses the vectors of the
+// WorldStats it fills, so it is cheap enough to run every frame:
+//
+//   ECS::WorldStats stats; // keep between frames
+//   world.sampleStats(stats);
+//   debugOverlay.updateECSStats(stats);
+//
+// Archetype explosion shows up as a growing archetype or list count with few
+// entities each (low fill, high bytes per entity), and churn as structural
+// changes and chunk allocations in the frame counters.
+// =============================================================================
+
+// occupancy of a set of chunks
+struct OccupancyStats {
+    uint32_t lists;    // chunk lists (one per archetype, group and shared set)
+    uint32_t chunks;
+    uint32_t entities;
+    size_t   slots;    // entity capacity of the chunks
+    size_t   rowBytes;   // bytes holding live entity rows
+    size_t   chunkBytes; // bytes of the chunks (they differ in size class)
+
+    float  getFillFactor()     const { return slots ? float(double(entities) / double(slots)) : 1.0f; }
+    size_t getChunkBytes()     const { return chunkBytes; }
+    size_t getWastedBytes()    const { return getChunkBytes() - rowBytes; } // headers, padding and open slots
+    float  getBytesPerEntity() const { return entities ? float(double(getChunkBytes()) / double(entities)) : 0.0f; }
+};
+
+struct ArchetypeStats : OccupancyStats {
+    ArchetypeID id;
+    ArchetypeMask mask;
+    ChunkSizeClass sizeClass; // class of new chunks
+};
+
+struct GroupStats : OccupancyStats {
+    GroupID id;
+};
+
+// structural changes since the previous sample
+struct StructuralCounters {
+    uint32_t entitiesCreated;
+    uint32_t entitiesRemoved;
+    uint32_t rowsMoved;       // component changes, group moves and compaction
+    uint32_t chunksRelinked;  // whole chunks moved between groups
+    uint32_t chunksAllocated;
+    uint32_t chunksFreed;
+    uint32_t listsCreated;
+};
+
+struct WorldStats {
+    OccupancyStats total;
+    std::vector<ArchetypeStats> archetypes; // indexed by ArchetypeID
+    std::vector<GroupStats> groups;         // groups with chunks, sorted by GroupID
+
+    size_t   reservedBytes;   // chunk memory held by the allocator
+    uint32_t freeChunkIDs;    // chunk blocks waiting for reuse
+    uint32_t freeEntityIDs;   // entity IDs waiting for reuse
+    StructuralCounters frame;
+};
+
+// wall time of one system in the last World::runSystems(), in seconds from
+// the start of the run (see SystemManager)
+struct SystemTiming {
+    SystemID id;
+    uint32_t thread; // JobSystem thread index, 0 is the thread that created it
+    double start;
+    double time;
+};
+
+struct ScheduleStats {
+    std::vector<SystemTiming> systems; // indexed by SystemID, zero when disabled
+    uint32_t threads;    // threads that ran systems, the calling thread included
+    uint32_t edges;      // dependencies in the frame graph
+    double frameTime;    // wall time of the run
+    double busyTime;     // sum of the system times
+    double criticalPath; // longest dependency chain by system time, the lower
+                         // bound on frameTime for any number of threads
+
+    float getParallelism() const { return frameTime > 0.0 ? float(busyTime / frameTime) : 0.0f; }
+};
+
+} // namespace ECS
\ No newline at end of file
@@ -0,0 +1,320 @@
+#pragma once
+
+#include "ecs/types.hpp"
+#include "ecs/stats.hpp"
+#include "utils/assert.hpp"
+#include "utils/job_system.hpp"
+#include "utils/timer.hpp"
+
+#include <algorithm> // for std::count, std::max, std::sort
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ECS {
+
+// =============================================================================
+// System Access Terms
+//
+// Each type in registerSystem<Ts...>() declares data the system touches,
+// spelled like Query terms:
+//
+//   T          reads and writes component T
+//   const T    reads component T
+//   Exclusive  makes structural changes (creates, removes or moves entities,
+//              plays back a CommandBuffer), runs with no other system
+//
+// Two systems conflict when one writes a component the other reads or
+// writes, or when either is exclusive.
+// =============================================================================
+
+struct Exclusive {};
+
+struct SystemAccess {
+    ArchetypeMask reads;
+    ArchetypeMask writes;
+    bool exclusive;
+
+    bool conflicts(const SystemAccess& other) const {
+        return exclusive || other.exclusive ||
+            writes.intersects(other.reads | other.writes) ||
+            other.writes.intersects(reads);
+    }
+};
+
+template <typename T>
+struct SystemAccessTerm {
+    static void addToAccess(SystemAccess& access) {
+        if constexpr (std::is_const_v<T>)
+            access.reads |= ArchetypeMask::bit(getComponentID<T>());
+        else
+            access.writes |= ArchetypeMask::bit(getComponentID<T>());
+    }
+};
+
+template <>
+struct SystemAccessTerm<Exclusive> {
+    static void addToAccess(SystemAccess& access) {
+        access.exclusive = true;
+    }
+};
+
+// =============================================================================
+// SystemManager
+//
+// Runs the registered systems once per run(). Every run builds a dependency
+// graph over the enabled systems: a system depends on each earlier registered
+// system it conflicts with, so conflicting systems keep registration order
+// and the others run concurrently as jobs on the JobSystem. The calling thread
+// runs jobs too while it waits.
+//
+// Systems running concurrently may iterate queries and write the columns they
+// declared, but must not make structural changes or create new queries (keep
+// Query objects as system members, created before the first run). Structural
+// changes go into a CommandBuffer played back by an Exclusive system.
+//
+// Systems that become ready together are started longest remaining chain
+// first, measured on the previous run, and each run's timings are kept in
+// getStats().
+// =============================================================================
+
+class SystemManager {
+public:
+    using SystemFn = std::function<void(float)>;
+
+    SystemManager(JobSystem& jobs);
+
+    SystemManager(const SystemManager&) = delete;
+    SystemManager& operator=(const SystemManager&) = delete;
+
+    template <typename... Ts>
+    SystemID registerSystem(std::string name, SystemFn fn);
+    bool hasSystem(SystemID id) const;
+    void setEnabled(SystemID id, bool enabled);
+    bool isEnabled(SystemID id) const;
+    const std::string& getName(SystemID id) const;
+    const SystemAccess& getAccess(SystemID id) const;
+    size_t getSystemCount() const { return systems.size(); }
+
+    void run(float dt);
+    const ScheduleStats& getStats() const { return stats; }
+
+    void print();
+
+private:
+    struct System {
+        SystemID id;
+        std::string name;
+        SystemAccess access;
+        SystemFn fn;
+        bool enabled;
+    };
+
+    void _buildGraph();
+    void _runNode(uint32_t n);
+    void _startNodes(std::vector<uint32_t>& ready);
+    void _updateStats();
+
+    JobSystem& jobs;
+    std::vector<System> systems;
+
+    // frame graph, nodes are enabled systems in registration order (which is
+    // a topological order since edges always point to later systems)
+    std::vector<SystemID> nodes;
+    std::vector<std::vector<uint32_t>> successors;
+    std::vector<uint32_t> dependencies; // dependency count per node
+    std::vector<double> ranks;          // longest chain to a sink, by last run
+
+    // run state
+    std::unique_ptr<std::atomic<uint32_t>[]> pending; // unfinished dependencies per node
+    JobCounter running;
+    float frameDt;
+
+    Timer frameTimer;
+    ScheduleStats stats;
+};
+
+// =============================================================================
+// SystemManager Functions
+// =============================================================================
+
+SystemManager::SystemManager(JobSystem& jobs)
+    : jobs(jobs),
+      systems({}),
+      nodes({}),
+      successors({}),
+      dependencies({}),
+      ranks({}),
+      pending(nullptr),
+      running(),
+      frameDt(0.0f),
+      frameTimer(),
+      stats() {}
+
+template <typename... Ts>
+SystemID SystemManager::registerSystem(std::string name, SystemFn fn) {
+    ASSERT(systems.size() < SYSTEM_ID_NULL, "System registry full.");
+    ASSERT(fn, "System " << name << " has no function.");
+
+    SystemAccess access{};
+    (SystemAccessTerm<Ts>::addToAccess(access), ...);
+
+    SystemID id = static_cast<SystemID>(systems.size());
+    systems.push_back({id, std::move(name), access, std::move(fn), true});
+    return id;
+}
+
+bool SystemManager::hasSystem(SystemID id) const {
+    return id < systems.size();
+}
+
+// a disabled system is left out of the graph from the next run on
+void SystemManager::setEnabled(SystemID id, bool enabled) {
+    ASSERT(hasSystem(id), "SystemID " << id << " does not exist.");
+    systems[id].enabled = enabled;
+}
+
+bool SystemManager::isEnabled(SystemID id) const {
+    ASSERT(hasSystem(id), "SystemID " << id << " does not exist.");
+    return systems[id].enabled;
+}
+
+const std::string& SystemManager::getName(SystemID id) const {
+    ASSERT(hasSystem(id), "SystemID " << id << " does not exist.");
+    return systems[id].name;
+}
+
+const SystemAccess& SystemManager::getAccess(SystemID id) const {
+    ASSERT(hasSystem(id), "SystemID " << id << " does not exist.");
+    return systems[id].access;
+}
+
+// runs every enabled system once and returns when all have finished
+void SystemManager::run(float dt) {
+    _buildGraph();
+    stats.systems.assign(systems.size(), SystemTiming{});
+    frameDt = dt;
+
+    pending.reset(new std::atomic<uint32_t>[nodes.size()]);
+    std::vector<uint32_t> ready;
+    for (uint32_t n = 0; n < nodes.size(); n++) {
+        pending[n].store(dependencies[n], std::memory_order_relaxed);
+        if (dependencies[n] == 0) ready.push_back(n);
+    }
+
+    frameTimer.reset();
+    _startNodes(ready);
+    jobs.wait(running);
+
+    stats.frameTime = frameTimer.elapsed();
+    _updateStats();
+}
+
+void SystemManager::print() {
+    std::cout << "systems:" << std::endl;
+    for (const System& s : systems) {
+        const SystemTiming& t = (s.id < stats.systems.size()) ? stats.systems[s.id] : SystemTiming{};
+        std::cout << "  - id: "        << s.id               << std::endl;
+        std::cout << "    name: "      << s.name             << std::endl;
+        std::cout << "    enabled: "   << s.enabled          << std::endl;
+        std::cout << "    exclusive: " << s.access.exclusive << std::endl;
+        std::cout << "    reads: "     << s.access.reads     << std::endl;
+        std::cout << "    writes: "    << s.access.writes    << std::endl;
+        std::cout << "    thread: "    << t.thread           << std::endl;
+        std::cout << "    time: "      << t.time             << std::endl;
+    }
+    std::cout << "schedule:" << std::endl;
+    std::cout << "  threads: "      << stats.threads      << std::endl;
+    std::cout << "  edges: "        << stats.edges        << std::endl;
+    std::cout << "  frameTime: "    << stats.frameTime    << std::endl;
+    std::cout << "  criticalPath: " << stats.criticalPath << std::endl;
+}
+
+// =============================================================================
+// SystemManager Private Functions
+// =============================================================================
+
+void SystemManager::_buildGraph() {
+    nodes.clear();
+    for (const System& s : systems) {
+        if (s.enabled) nodes.push_back(s.id);
+    }
+
+    successors.assign(nodes.size(), {});
+    dependencies.assign(nodes.size(), 0);
+    stats.edges = 0;
+    for (uint32_t j = 0; j < nodes.size(); j++) {
+        const SystemAccess& access = systems[nodes[j]].access;
+        for (uint32_t i = 0; i < j; i++) {
+            if (!access.conflicts(systems[nodes[i]].access)) continue;
+            successors[i].push_back(j);
+            dependencies[j]++;
+            stats.edges++;
+        }
+    }
+
+    // start priority, systems not timed yet count as free
+    ranks.assign(nodes.size(), 0.0);
+    for (uint32_t n = static_cast<uint32_t>(nodes.size()); n-- > 0;) {
+        SystemID id = nodes[n];
+        double chain = 0.0;
+        for (uint32_t s : successors[n]) chain = std::max(chain, ranks[s]);
+        ranks[n] = chain + ((id < stats.systems.size()) ? stats.systems[id].time : 0.0);
+    }
+}
+
+// runs a system, then starts the successors it was the last dependency of
+void SystemManager::_runNode(uint32_t n) {
+    System& system = systems[nodes[n]];
+    int thread = jobs.getThreadIndex();
+
+    double start = frameTimer.elapsed();
+    system.fn(frameDt);
+    double end = frameTimer.elapsed();
+
+    // threads the JobSystem does not know are counted as one extra thread
+    uint32_t t = (thread == JobSystem::THREAD_INDEX_NULL) ? uint32_t(jobs.getThreadCount()) : uint32_t(thread);
+    stats.systems[system.id] = {system.id, t, start, end - start};
+
+    std::vector<uint32_t> ready;
+    for (uint32_t s : successors[n]) {
+        if (pending[s].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            ready.push_back(s);
+    }
+    _startNodes(ready);
+}
+
+// deques are LIFO, so the longest chain is pushed last to be taken first
+void SystemManager::_startNodes(std::vector<uint32_t>& ready) {
+    std::sort(ready.begin(), ready.end(), [this](uint32_t a, uint32_t b) {
+        return ranks[a] < ranks[b];
+    });
+    for (uint32_t n : ready) {
+        jobs.run([this, n] { _runNode(n); }, &running);
+    }
+}
+
+// critical path by the measured system times, nodes are in topological order
+void SystemManager::_updateStats() {
+    std::vector<double> earliest(nodes.size(), 0.0);
+    std::vector<bool> used(jobs.getThreadCount() + 1, false);
+
+    stats.busyTime = 0.0;
+    stats.criticalPath = 0.0;
+    for (uint32_t n = 0; n < nodes.size(); n++) {
+        const SystemTiming& t = stats.systems[nodes[n]];
+        double finish = earliest[n] + t.time;
+        for (uint32_t s : successors[n]) earliest[s] = std::max(earliest[s], finish);
+
+        stats.busyTime += t.time;
+        stats.criticalPath = std::max(stats.criticalPath, finish);
+        used[t.thread] = true;
+    }
+    stats.threads = static_cast<uint32_t>(std::count(used.begin(), used.end(), true));
+}
+
+} // namespace ECS
@@ -1,21 +1,44 @@
 #pragma once
 
+#include "ecs/bitset.hpp"
+
+#include <cstddef> // for size_t
 #include <cstdint>
 #include <limits> // for std::numeric_limits
 #include <type_traits>
 
+// number of component types (bits per archetype mask), a multiple of 64
+#ifndef ECS_MAX_COMPONENTS
+    #define ECS_MAX_COMPONENTS 128
+#endif
+
+// component IDs below this are reserved for the registration table (see
+// ECS_COMPONENT_ID), the others are derived from the type name hash
+#ifndef ECS_FIXED_COMPONENT_IDS
+    #define ECS_FIXED_COMPONENT_IDS 16
+#endif
+
 namespace ECS {
 
 class Archetype;
+class Autosave;
 class ArchetypeManager;
 class Chunk;
+class ChunkList;
 class ChunkManager;
 class Component;
 class ComponentManager;
 class Entity;
 class EntityManager;
+class EventManager;
+class QueryCache;
+class QueryManager;
+class SharedComponentManager;
+class Snapshot;
+class SystemManager;
+struct SharedSet;
 
-using mask_t = uint64_t; // 64 bit mask where each bit represents a component
+using mask_t = Bitset<ECS_MAX_COMPONENTS>; // each bit represents a component
 
 // =============================================================================
 // Archetype
@@ -38,10 +61,45 @@ constexpr const GroupID  GROUP_ID_NULL  = std::numeric_limits<GroupID >::max();
 constexpr const ChunkID  CHUNK_ID_NULL  = std::numeric_limits<ChunkID >::max();
 constexpr const ChunkIdx CHUNK_IDX_NULL = std::numeric_limits<ChunkIdx>::max();
 
-static constexpr ChunkIdx CHUNK_TOTAL_SIZE  = 16 * 1024; // 16 kilobytes
-static constexpr ChunkIdx CHUNK_HEADER_SIZE = 256;
-static constexpr ChunkIdx CHUNK_BUFFER_SIZE = CHUNK_TOTAL_SIZE - CHUNK_HEADER_SIZE;
-static constexpr size_t CHUNK_COMPONENT_CAPACITY = 16;
+// chunk blocks come in size classes, an archetype allocates from one class at
+// a time (see ChunkManager::_selectSizeClass)
+enum class ChunkSizeClass : uint8_t {
+    SMALL,  //  4KB, rare archetypes
+    MEDIUM, // 16KB
+    LARGE,  // 64KB, hot archetypes and large rows
+    AUTO,   // hint only, the class follows row size and population
+};
+
+static constexpr size_t   CHUNK_SIZE_CLASS_COUNT   = 3;
+static constexpr size_t   CHUNK_MIN_SIZE           = 4 * 1024;  // SMALL
+static constexpr size_t   CHUNK_MAX_SIZE           = 64 * 1024; // LARGE
+static constexpr ChunkIdx CHUNK_HEADER_SIZE        = 320;
+static constexpr ChunkIdx CHUNK_MIN_ROWS           = 16; // rows a class must fit for an archetype to start in it
+static constexpr size_t   CHUNK_COMPONENT_CAPACITY = 16;
+static constexpr uint8_t  CHUNK_COLUMN_NULL        = std::numeric_limits<uint8_t>::max(); // component has no column in a chunk
+static constexpr size_t   CHUNK_COLUMN_ALIGNMENT   = 64; // bytes, every column starts on a cache line
+static constexpr ChunkIdx CHUNK_CAPACITY_ALIGNMENT = 16; // entities, 16 x 4B = one 64B line
+static constexpr size_t   CHUNK_ENABLE_WORDS_MAX   = CHUNK_MAX_SIZE / sizeof(uint32_t) / 64; // enable mask words of the most rows a chunk can hold
+
+constexpr size_t getChunkSize(ChunkSizeClass sizeClass) {
+    return CHUNK_MIN_SIZE << (2 * static_cast<size_t>(sizeClass));
+}
+
+// hints for chunk column kernels, see Query::forEachChunk()
+#if defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER)
+    #define ECS_RESTRICT __restrict
+#else
+    #define ECS_RESTRICT
+#endif
+
+template <typename T>
+inline T* assumeColumnAligned(T* ptr) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<T*>(__builtin_assume_aligned(ptr, CHUNK_COLUMN_ALIGNMENT));
+#else
+    return ptr;
+#endif
+}
 
 // =============================================================================
 // Component
@@ -49,35 +107,58 @@ static constexpr size_t CHUNK_COMPONENT_CAPACITY = 16;
 
 // #define typeof(C) getComponentID<C>()
 
-using ComponentID   = uint8_t;
+using ComponentID   = uint16_t;
 using ComponentMask = mask_t; // only a single bit active
 using ComponentSize = uint16_t;
 
-using SharedComponentID = uint16_t;
+using SharedComponentID = uint16_t; // one interned value of a shared component
+using SharedSetID       = uint32_t; // interned set of shared values, one per chunk list
 
-constexpr const size_t COMPONENT_CAPACITY = sizeof(ComponentMask) * 8;
+constexpr const size_t COMPONENT_CAPACITY = ECS_MAX_COMPONENTS;
+constexpr const size_t COMPONENT_FIXED_ID_COUNT = ECS_FIXED_COMPONENT_IDS;
+static_assert(COMPONENT_FIXED_ID_COUNT < COMPONENT_CAPACITY, "ECS_FIXED_COMPONENT_IDS must leave IDs for unlisted types");
 
 constexpr const ComponentID   COMPONENT_ID_NULL   = std::numeric_limits<ComponentID  >::max();
-constexpr const ComponentMask COMPONENT_MASK_NULL = 0;
+constexpr const ComponentMask COMPONENT_MASK_NULL = {};
 constexpr const ComponentSize COMPONENT_SIZE_NULL = std::numeric_limits<ComponentSize>::max();
 
-inline ComponentID getNextComponentID() {
-    static ComponentID counter = 0;
-    return counter++;
-}
-
-template <typename C>
-inline ComponentID getComponentID() {
-    static ComponentID id = getNextComponentID();
-    return id;
-}
+constexpr const SharedComponentID SHARED_COMPONENT_ID_NULL = std::numeric_limits<SharedComponentID>::max();
+constexpr const SharedSetID       SHARED_SET_ID_EMPTY      = 0; // entities without shared components
 
 // =============================================================================
 // Entity
 // =============================================================================
 
 using EntityID  = uint32_t;
+using EntityGeneration = uint32_t; // times an entity ID was freed, tells reuses apart
 
 constexpr const EntityID  ENTITY_ID_NULL  = std::numeric_limits<EntityID >::max();
 
-} // namespace ECS
\ No newline at end of file
+// =============================================================================
+// Observer
+// =============================================================================
+
+using ObserverID = uint16_t;
+
+constexpr const ObserverID OBSERVER_ID_NULL = std::numeric_limits<ObserverID>::max();
+
+// =============================================================================
+// Query
+// =============================================================================
+
+using QueryID = uint16_t;
+
+constexpr const QueryID QUERY_ID_NULL = std::numeric_limits<QueryID>::max();
+
+// =============================================================================
+// System
+// =============================================================================
+
+using SystemID = uint16_t;
+
+constexpr const SystemID SYSTEM_ID_NULL = std::numeric_limits<SystemID>::max();
+
+} // namespace ECS
+
+// the registry uses the aliases above
+#include "ecs/component_registry.hpp"
\ No newline at end of file
@@ -5,11 +5,23 @@
 #include "ecs/archetype_manager.hpp"
 #include "ecs/chunk.hpp"
 #include "ecs/chunk_manager.hpp"
+#include "ecs/command_buffer.hpp"
 #include "ecs/component.hpp"
 #include "ecs/component_manager.hpp"
 #include "ecs/entity.hpp"
 #include "ecs/entity_manager.hpp"
+#include "ecs/event_manager.hpp"
+#include "ecs/query.hpp"
+#include "ecs/query_manager.hpp"
+#include "ecs/shared_component_manager.hpp"
+#include "ecs/stats.hpp"
+#include "ecs/system_manager.hpp"
 #include "utils/assert.hpp"
+#include "utils/job_system.hpp"
+
+#include <algorithm> // for std::sort, std::stable_sort
+#include <string>
+#include <vector>
 
 namespace ECS {
 
@@ -18,6 +30,9 @@ namespace ECS {
 // =============================================================================
 
 class World {
+    friend class Autosave;
+    friend class Snapshot;
+
 public:
     World();
 
@@ -34,31 +49,114 @@ public:
     bool isTag() const;
     bool isTag(ComponentID cID) const;
 
+    // enableable component functions
+    template <typename C>
+    ComponentID registerEnableableComponent();
+    template <typename C>
+    bool isEnableable() const;
+    bool isEnableable(ComponentID cID) const;
+    template <typename C>
+    void setComponentEnabled(EntityID eID, bool enabled);
+    template <typename C>
+    bool isComponentEnabled(EntityID eID);
+
+    // archetype functions
+    template <typename... Components>
+    ArchetypeID registerArchetype(ChunkSizeClass sizeHint = ChunkSizeClass::AUTO);
+
+    // shared component functions
+    template <typename S>
+    ComponentID registerSharedComponent();
+    template <typename S>
+    bool isShared() const;
+    bool isShared(ComponentID cID) const;
+    template <typename S>
+    SharedComponentID getSharedComponentID(const S& value);
+    template <typename... S>
+    SharedSetID getSharedSet(const S&... values);
+    template <typename S>
+    void setSharedComponent(EntityID eID, const S& value);
+    template <typename S>
+    void removeSharedComponent(EntityID eID);
+    template <typename S>
+    const S& getSharedComponent(EntityID eID);
+
     // entity functions
     template<typename... Components>
     EntityID createEntity(Components&&... data);
     template<typename... Components>
     EntityID createEntityInGroup(GroupID gID, Components&&... data);
+    template<typename... Components>
+    EntityID createEntityWithShared(GroupID gID, SharedSetID sID, Components&&... data);
+    template<typename... Components>
+    std::vector<EntityID> createEntities(size_t n, GroupID gID, const Components&... prototypes);
+    template<typename... Components>
+    std::vector<EntityID> createEntitiesWithShared(size_t n, GroupID gID, SharedSetID sID, const Components&... prototypes);
+    template<typename... Components>
+    std::vector<EntityID> createEntitiesFromColumns(size_t n, GroupID gID, const Components*... columns);
     void removeEntity(EntityID eID);
-    // template <typename C>
-    // void insertComponentIntoEntity(C&& data);
-    // template <typename C>
-    // void removeComponentFromEntity();
-    // bool hasEntity(EntityID id) const;
+    template <typename... Ts>
+    void destroyMatching(Query<Ts...>& query);
+    void destroyGroup(GroupID gID);
+    void moveEntityToGroup(EntityID eID, GroupID gID);
+    void moveEntitiesToGroup(const EntityID* eIDs, size_t n, GroupID gID);
+    template <typename C>
+    void insertComponentIntoEntity(EntityID eID, C&& data = {});
+    template <typename C>
+    void removeComponentFromEntity(EntityID eID);
+    bool hasEntity(EntityID eID) const;
+    const Entity& getEntity(EntityID eID);
+
+    // command buffer functions
+    void playback(CommandBuffer& cb);
+
+    // observer functions
+    template <typename... Cs>
+    ObserverID observe(ObserverFn fn);
+    void removeObserver(ObserverID id);
+    void flushEvents();
+
+    // query functions
+    template <typename... Ts>
+    Query<Ts...> query();
+    template <typename... Ts, typename Fn>
+    void forEachChunk(Fn&& fn);
+    template <typename... Ts, typename Fn>
+    void parallelForEach(Fn&& fn);
 
-    // QueryIterator query(Query q);
+    // system functions
+    template <typename... Ts>
+    SystemID registerSystem(std::string name, SystemManager::SystemFn fn);
+    void setSystemEnabled(SystemID id, bool enabled);
+    void runSystems(float dt);
+    const ScheduleStats& getScheduleStats() const;
+    JobSystem& getJobSystem();
+
+    // memory functions
+    CompactionStats compact(double budget);
+    float getFillFactor() const;
+
+    // stats functions
+    void sampleStats(WorldStats& stats);
 
     // miscellaneous functions
+    void setZeroFreedChunks(bool zero);
+    uint32_t getVersion() const;
     void print();
 
 private:
-    ArchetypeManager archetypeMgr;
-    ChunkManager chunkMgr;
+    ArchetypeID _getArchetypeWithShared(ArchetypeID aID, SharedSetID sID);
+
+    // NOTE: declaration order matters, managers reference the ones above them
     ComponentManager componentMgr;
+    SharedComponentManager sharedMgr;
     EntityManager entityMgr;
-    // EventManager eventMgr;
-    // QueryManager queryMgr;
-    // SystemManager systemMgr;
+    QueryManager queryMgr;
+    ArchetypeManager archetypeMgr;
+    ChunkManager chunkMgr;
+    EventManager eventMgr;
+    JobSystem jobSystem;
+    SystemManager systemMgr;
 };
 
 // =============================================================================
@@ -66,10 +164,15 @@ private:
 // =============================================================================
 
 World::World()
-    : archetypeMgr(componentMgr),
-      chunkMgr(archetypeMgr, entityMgr),
-      componentMgr({}),
-      entityMgr({}) {}
+    : componentMgr({}),
+      sharedMgr(),
+      entityMgr({}),
+      queryMgr({}),
+      archetypeMgr(componentMgr, queryMgr),
+      chunkMgr(archetypeMgr, entityMgr, queryMgr, sharedMgr),
+      eventMgr(chunkMgr, entityMgr),
+      jobSystem(),
+      systemMgr(jobSystem) {}
 
 // =============================================================================
 // World Chunk Functions
@@ -103,7 +206,137 @@ bool World::isTag() const {
 }
 
 bool World::isTag(ComponentID cID) const {
-    return componentMgr.hasComponent(cID);
+    return componentMgr.isTag(cID);
+}
+
+// =============================================================================
+// World Enableable Component Functions
+//
+// An enableable component can be switched off per entity without a structural
+// change: the entity keeps its archetype and row, and queries skip it as if
+// the component were absent (Without<C> visits it). Register it before the
+// first archetype holding it is created, e.g. a Stunned tag:
+//
+//   world.registerEnableableComponent<Stunned>();
+//   world.setComponentEnabled<Stunned>(eID, false); // one bit write
+//
+// Rows created or moved into a chunk start with the component enabled, a
+// move keeps the bit of a component the entity already had.
+// =============================================================================
+
+template <typename C>
+ComponentID World::registerEnableableComponent() {
+    return componentMgr.registerEnableableComponent<C>().getID();
+}
+
+template <typename C>
+bool World::isEnableable() const {
+    return isEnableable(getComponentID<C>());
+}
+
+bool World::isEnableable(ComponentID cID) const {
+    return componentMgr.isEnableable(cID);
+}
+
+template <typename C>
+void World::setComponentEnabled(EntityID eID, bool enabled) {
+    ASSERT(entityMgr.hasEntity(eID), "Entity id does not exist");
+    ASSERT(componentMgr.isEnableable<C>(), "Component is not a registered enableable component");
+    const Entity& entity = entityMgr.getEntity(eID);
+    chunkMgr.getChunk(entity.getChunkID()).setEnabled<C>(entity.getChunkIdx(), enabled);
+}
+
+template <typename C>
+bool World::isComponentEnabled(EntityID eID) {
+    ASSERT(entityMgr.hasEntity(eID), "Entity id does not exist");
+    const Entity& entity = entityMgr.getEntity(eID);
+    return chunkMgr.getChunk(entity.getChunkID()).isEnabled<C>(entity.getChunkIdx());
+}
+
+// =============================================================================
+// World Archetype Functions
+// =============================================================================
+
+// archetypes are otherwise created on first use, registering one up front
+// lets its chunk size class be pinned, e.g. SMALL for a handful of singletons
+// or LARGE for a population known to be huge, AUTO lets the World choose
+template <typename... Components>
+ArchetypeID World::registerArchetype(ChunkSizeClass sizeHint) {
+    ArchetypeID aID = archetypeMgr.getOrCreateArchetype<Components...>();
+    archetypeMgr.getArchetype(aID).setSizeHint(sizeHint);
+    return aID;
+}
+
+// =============================================================================
+// World Shared Component Functions
+//
+// A shared component has one value per chunk instead of one per entity.
+// Entities with equal shared values are packed into the same chunk list, so
+// per entity storage is saved and a system sees each value once per chunk.
+// Changing a shared value moves the entity to another chunk list.
+// =============================================================================
+
+template <typename S>
+ComponentID World::registerSharedComponent() {
+    return componentMgr.registerSharedComponent<S>().getID();
+}
+
+template <typename S>
+bool World::isShared() const {
+    return isShared(getComponentID<S>());
+}
+
+bool World::isShared(ComponentID cID) const {
+    return componentMgr.isShared(cID);
+}
+
+template <typename S>
+SharedComponentID World::getSharedComponentID(const S& value) {
+    ASSERT(componentMgr.isShared<S>(), "Component is not a registered shared component");
+    return sharedMgr.getOrCreateValue(value);
+}
+
+template <typename... S>
+SharedSetID World::getSharedSet(const S&... values) {
+    return sharedMgr.getOrCreateSet({getSharedComponentID(values)...});
+}
+
+template <typename S>
+void World::setSharedComponent(EntityID eID, const S& value) {
+    ASSERT(entityMgr.hasEntity(eID), "Entity id does not exist");
+    SharedComponentID vID = getSharedComponentID(value);
+    ComponentID cID = getComponentID<S>();
+
+    Chunk& chunk = chunkMgr.getChunk(entityMgr.getEntity(eID).getChunkID());
+    Archetype* dst = chunk.getArchetype();
+    if (!dst->hasComponent(cID))
+        dst = &archetypeMgr.getInsertArchetype(*dst, cID);
+
+    SharedSetID sID = sharedMgr.getSetWith(chunk.getSharedSetID(), vID);
+    chunkMgr.moveEntity(eID, *dst, chunk.getGroupID(), sID);
+}
+
+// removing a shared component the entity does not have does nothing
+template <typename S>
+void World::removeSharedComponent(EntityID eID) {
+    ASSERT(entityMgr.hasEntity(eID), "Entity id does not exist");
+    ASSERT(componentMgr.isShared<S>(), "Component is not a registered shared component");
+    ComponentID cID = getComponentID<S>();
+
+    Chunk& chunk = chunkMgr.getChunk(entityMgr.getEntity(eID).getChunkID());
+    if (!chunk.hasComponent(cID)) return;
+
+    Archetype& dst = archetypeMgr.getRemoveArchetype(*chunk.getArchetype(), cID);
+    SharedSetID sID = sharedMgr.getSetWithout(chunk.getSharedSetID(), cID);
+    chunkMgr.moveEntity(eID, dst, chunk.getGroupID(), sID);
+}
+
+template <typename S>
+const S& World::getSharedComponent(EntityID eID) {
+    ASSERT(entityMgr.hasEntity(eID), "Entity id does not exist");
+    const S* value = chunkMgr.getChunk(entityMgr.getEntity(eID).getChunkID()).getShared<S>();
+    ASSERT(value != nullptr, "Entity does not have the shared component");
+    return *value;
 }
 
 // =============================================================================
@@ -117,28 +350,416 @@ EntityID World::createEntity(Components&&... data) {
 
 template<typename... Components>
 EntityID World::createEntityInGroup(GroupID gID, Components&&... data) {
+    return createEntityWithShared(gID, SHARED_SET_ID_EMPTY, std::forward<Components>(data)...);
+}
+
+// the entity also gets the shared components of the set (see getSharedSet())
+template<typename... Components>
+EntityID World::createEntityWithShared(GroupID gID, SharedSetID sID, Components&&... data) {
     // TODO: validate componentes are registered
     // (void)std::initializer_list<int>{(registerComponent<Components>(), 0)...};
     EntityID    eID = entityMgr.createEntity();
-    ArchetypeID aID = archetypeMgr.getOrCreateArchetype<Components...>();
-    chunkMgr.insertEntity(eID, aID, gID, std::forward<Components>(data)...);
+    ArchetypeID aID = _getArchetypeWithShared(archetypeMgr.getOrCreateArchetype<Components...>(), sID);
+    chunkMgr.insertEntity(eID, aID, gID, sID, std::forward<Components>(data)...);
     return eID;
 }
 
+// creates n entities that all start as copies of the prototypes
+template<typename... Components>
+std::vector<EntityID> World::createEntities(size_t n, GroupID gID, const Components&... prototypes) {
+    return createEntitiesWithShared(n, gID, SHARED_SET_ID_EMPTY, prototypes...);
+}
+
+template<typename... Components>
+std::vector<EntityID> World::createEntitiesWithShared(size_t n, GroupID gID, SharedSetID sID, const Components&... prototypes) {
+    std::vector<EntityID> eIDs(n);
+    entityMgr.createEntities(n, eIDs.data());
+    ArchetypeID aID = _getArchetypeWithShared(archetypeMgr.getOrCreateArchetype<Components...>(), sID);
+    chunkMgr.insertEntities(eIDs.data(), n, aID, gID, sID, prototypes...);
+    return eIDs;
+}
+
+// creates n entities, entity i takes element i of every column array
+template<typename... Components>
+std::vector<EntityID> World::createEntitiesFromColumns(size_t n, GroupID gID, const Components*... columns) {
+    std::vector<EntityID> eIDs(n);
+    entityMgr.createEntities(n, eIDs.data());
+    ArchetypeID aID = archetypeMgr.getOrCreateArchetype<Components...>();
+    chunkMgr.insertEntityColumns(eIDs.data(), n, aID, gID, SHARED_SET_ID_EMPTY, columns...);
+    return eIDs;
+}
+
 void World::removeEntity(EntityID eID) {
     ASSERT(entityMgr.hasEntity(eID), "Entity id does not exist");
     chunkMgr.removeEntity(eID);
 }
 
+bool World::hasEntity(EntityID eID) const {
+    return entityMgr.hasEntity(eID);
+}
+
+// chunk location of the entity, valid until its next structural change
+const Entity& World::getEntity(EntityID eID) {
+    return entityMgr.getEntity(eID);
+}
+
+// removes every entity matched by the query, releasing whole chunks where
+// every row passes its enable filters and removing the other rows one by one
+template <typename... Ts>
+void World::destroyMatching(Query<Ts...>& query) {
+    std::vector<EntityID> eIDs;
+    for (ChunkList* list : query.getCache().getLists()) {
+        Chunk* chunk = list->getHeadChunk();
+        if (!chunk || !query.matchesList(*list)) continue;
+        if (chunk->getArchetype()->getEnableColumns().empty()) {
+            chunkMgr.removeEntitiesInList(*list);
+            continue;
+        }
+
+        while (chunk) {
+            Chunk* next = chunk->getNextChunk();
+            uint64_t rows[CHUNK_ENABLE_WORDS_MAX];
+            if (!query.getRows(*chunk, rows) || isEnableMaskFull(rows, chunk->getCount())) {
+                chunkMgr.removeEntitiesInChunk(*chunk);
+            } else {
+                // IDs first, swap-removes reorder the rows of the chunk
+                eIDs.clear();
+                forEachEnabledRun(rows, chunk->getCount(), [&](ChunkIdx beg, ChunkIdx end) {
+                    eIDs.insert(eIDs.end(), chunk->getEntityIDs() + beg, chunk->getEntityIDs() + end);
+                });
+                for (EntityID eID : eIDs) chunkMgr.removeEntity(eID);
+            }
+            chunk = next;
+        }
+    }
+}
+
+// removes every entity in the group by releasing whole chunks
+void World::destroyGroup(GroupID gID) {
+    chunkMgr.removeEntitiesInGroup(gID);
+}
+
+// moves an entity into another group, keeping its ID, components and shared
+// values (e.g. a unit crossing a map cell border)
+void World::moveEntityToGroup(EntityID eID, GroupID gID) {
+    ASSERT(entityMgr.hasEntity(eID), "Entity id does not exist");
+    chunkMgr.moveEntityToGroup(eID, gID);
+}
+
+// batched moveEntityToGroup(), chunks whose every entity moves are handed to
+// the destination group without copying any rows
+void World::moveEntitiesToGroup(const EntityID* eIDs, size_t n, GroupID gID) {
+    for (size_t i = 0; i < n; i++) {
+        ASSERT(entityMgr.hasEntity(eIDs[i]), "Entity id does not exist");
+    }
+    chunkMgr.moveEntitiesToGroup(eIDs, n, gID);
+}
+
+template <typename C>
+void World::insertComponentIntoEntity(EntityID eID, C&& data) {
+    ASSERT(entityMgr.hasEntity(eID), "Entity id does not exist");
+    ASSERT(componentMgr.hasComponent<C>(), "Component is not registered");
+    ASSERT(!componentMgr.isShared<C>(), "Use setSharedComponent for shared components");
+    chunkMgr.insertEntityComponent(eID, std::forward<C>(data));
+}
+
+template <typename C>
+void World::removeComponentFromEntity(EntityID eID) {
+    ASSERT(entityMgr.hasEntity(eID), "Entity id does not exist");
+    ASSERT(componentMgr.hasComponent<C>(), "Component is not registered");
+    ASSERT(!componentMgr.isShared<C>(), "Use removeSharedComponent for shared components");
+    chunkMgr.removeEntityComponent(eID, getComponentID<C>());
+}
+
+// =============================================================================
+// World Command Buffer Functions
+// =============================================================================
+
+void World::playback(CommandBuffer& cb) {
+    const std::vector<Command>& commands = cb.commands;
+    cb.created.clear();
+
+    // 1. remove entities, ignoring duplicates and entities that no longer exist
+    std::vector<EntityID> removes;
+    for (const Command& cmd : commands) {
+        if (cmd.type == CommandType::REMOVE_ENTITY)
+            removes.push_back(cmd.eID);
+    }
+    std::sort(removes.begin(), removes.end());
+    removes.erase(std::unique(removes.begin(), removes.end()), removes.end());
+
+    for (EntityID eID : removes) {
+        if (entityMgr.hasEntity(eID))
+            chunkMgr.removeEntity(eID);
+    }
+
+    // 2. fold component inserts, removes and group moves per entity (in
+    //    recording order) into one destination archetype and group, the
+    //    archetype found by walking the neighbor graph
+    std::vector<uint32_t> changes;
+    for (uint32_t i = 0; i < commands.size(); i++) {
+        CommandType type = commands[i].type;
+        if (type == CommandType::INSERT_COMPONENT ||
+            type == CommandType::REMOVE_COMPONENT ||
+            type == CommandType::MOVE_TO_GROUP)
+            changes.push_back(i);
+    }
+    std::stable_sort(changes.begin(), changes.end(), [&](uint32_t a, uint32_t b) {
+        return commands[a].eID < commands[b].eID;
+    });
+
+    struct Move {
+        EntityID eID;
+        Archetype* dst;
+        GroupID gID;
+        SharedSetID sID;
+        uint32_t beg; // first index into changes
+        uint32_t end; // one past last index into changes
+    };
+
+    std::vector<Move> moves;
+    for (uint32_t beg = 0, end = 0; beg < changes.size(); beg = end) {
+        EntityID eID = commands[changes[beg]].eID;
+        end = beg + 1;
+        while (end < changes.size() && commands[changes[end]].eID == eID) end++;
+
+        if (!entityMgr.hasEntity(eID)) continue;
+
+        Chunk& chunk = chunkMgr.getChunk(entityMgr.getEntity(eID).getChunkID());
+        Archetype* dst = chunk.getArchetype();
+        GroupID gID = chunk.getGroupID();
+
+        for (uint32_t i = beg; i < end; i++) {
+            const Command& cmd = commands[changes[i]];
+            if (cmd.type == CommandType::MOVE_TO_GROUP) {
+                gID = cmd.gID;
+                continue;
+            }
+            ASSERT(!componentMgr.isShared(cmd.cID), "Shared components cannot be recorded in a CommandBuffer");
+            bool has = dst->hasComponent(cmd.cID);
+            if (cmd.type == CommandType::INSERT_COMPONENT && !has)
+                dst = &archetypeMgr.getInsertArchetype(*dst, cmd.cID);
+            else if (cmd.type == CommandType::REMOVE_COMPONENT && has)
+                dst = &archetypeMgr.getRemoveArchetype(*dst, cmd.cID);
+        }
+
+        moves.push_back({eID, dst, gID, chunk.getSharedSetID(), beg, end});
+    }
+
+    // sort by destination chunk list so each destination chunk is filled once
+    std::sort(moves.begin(), moves.end(), [](const Move& a, const Move& b) {
+        if (a.dst->getID() != b.dst->getID()) return a.dst->getID() < b.dst->getID();
+        if (a.gID != b.gID) return a.gID < b.gID;
+        return a.sID < b.sID;
+    });
+
+    for (const Move& move : moves) {
+        chunkMgr.moveEntity(move.eID, *move.dst, move.gID, move.sID);
+
+        // later inserts of the same component overwrite earlier ones
+        for (uint32_t i = move.beg; i < move.end; i++) {
+            const Command& cmd = commands[changes[i]];
+            if (cmd.type != CommandType::INSERT_COMPONENT) continue;
+            if (!move.dst->hasComponent(cmd.cID)) continue;
+            const CommandData& rec = cb.records[cmd.dataBeg];
+            chunkMgr.insertEntityComponent(move.eID, rec.cID, cb.bytes.data() + rec.offset);
+        }
+    }
+
+    // 3. create entities sorted by destination chunk list
+    struct Create {
+        ArchetypeID aID;
+        GroupID gID;
+        uint32_t cmdIdx;
+        uint32_t createdIdx;
+    };
+
+    std::vector<Create> creates;
+    for (uint32_t i = 0; i < commands.size(); i++) {
+        const Command& cmd = commands[i];
+        if (cmd.type != CommandType::CREATE_ENTITY) continue;
+        ArchetypeID aID = archetypeMgr.getOrCreateArchetype(cmd.mask);
+        creates.push_back({aID, cmd.gID, i, static_cast<uint32_t>(creates.size())});
+    }
+    std::sort(creates.begin(), creates.end(), [](const Create& a, const Create& b) {
+        if (a.aID != b.aID) return a.aID < b.aID;
+        if (a.gID != b.gID) return a.gID < b.gID;
+        return a.createdIdx < b.createdIdx;
+    });
+
+    cb.created.resize(creates.size(), ENTITY_ID_NULL);
+    for (const Create& create : creates) {
+        const Command& cmd = commands[create.cmdIdx];
+        EntityID eID = entityMgr.createEntity();
+        chunkMgr.insertEntity(eID, create.aID, create.gID, SHARED_SET_ID_EMPTY);
+        for (uint32_t r = cmd.dataBeg; r < cmd.dataEnd; r++) {
+            const CommandData& rec = cb.records[r];
+            chunkMgr.insertEntityComponent(eID, rec.cID, cb.bytes.data() + rec.offset);
+        }
+        cb.created[create.createdIdx] = eID;
+    }
+
+    cb.clear();
+    eventMgr.flush();
+}
+
+// =============================================================================
+// World Observer Functions
+//
+// Observers hear about created, destroyed and moved entities in batches (see
+// EventManager). Batches are delivered by flushEvents() and at the end of
+// every playback(), e.g. once a frame after the systems ran:
+//
+//   world.observe<Position>([&](const ObserverBatch& b) {
+//       if (b.type == StructuralEventType::CREATED) spatialIndex.insert(b.eIDs, b.count, *b.chunk);
+//   });
+//
+// =============================================================================
+
+// observes entities having every component in Cs (every entity if empty)
+template <typename... Cs>
+ObserverID World::observe(ObserverFn fn) {
+    ArchetypeMask mask{};
+    ((mask |= ArchetypeMask::bit(getComponentID<Cs>())), ...);
+    return eventMgr.addObserver(mask, std::move(fn));
+}
+
+void World::removeObserver(ObserverID id) {
+    eventMgr.removeObserver(id);
+}
+
+void World::flushEvents() {
+    eventMgr.flush();
+}
+
+// =============================================================================
+// World Query Functions
+// =============================================================================
+
+template <typename... Ts>
+Query<Ts...> World::query() {
+    // Without<> on an enableable component filters rows, not archetypes
+    QueryKey key = Query<Ts...>::makeKey();
+    key.disabled = key.without & componentMgr.getEnableableMask();
+    key.without &= ~componentMgr.getEnableableMask();
+
+    QueryCache& cache = queryMgr.getOrCreateQuery(key);
+    return Query<Ts...>(cache, chunkMgr.getVersionCounter());
+}
+
+template <typename... Ts, typename Fn>
+void World::forEachChunk(Fn&& fn) {
+    query<Ts...>().forEachChunk(std::forward<Fn>(fn));
+}
+
+// Query::parallelForEach() on the JobSystem of the World, e.g. a movement pass:
+//
+//   world.parallelForEach<Position, const Velocity>([dt](ChunkIdx n, const EntityID*,
+//           Position* p, const Velocity* v) {
+//       for (ChunkIdx i = 0; i < n; i++) { p[i].x += v[i].x * dt; p[i].y += v[i].y * dt; }
+//   });
+//
+// NOTE: calling it from a system is fine, the waiting thread runs the chunk jobs
+template <typename... Ts, typename Fn>
+void World::parallelForEach(Fn&& fn) {
+    query<Ts...>().parallelForEach(jobSystem, std::forward<Fn>(fn));
+}
+
+// =============================================================================
+// World System Functions
+//
+// Systems declare the components they read (const T) and write (T), and
+// systems that do not conflict run concurrently, see SystemManager:
+//
+//   MovementSystem movement(world);
+//   world.registerSystem<Position, const Velocity, Bounds>("movement",
+//       [&](float dt) { movement.update(dt); });
+//   world.runSystems(dt);
+//
+// =============================================================================
+
+template <typename... Ts>
+SystemID World::registerSystem(std::string name, SystemManager::SystemFn fn) {
+    return systemMgr.registerSystem<Ts...>(std::move(name), std::move(fn));
+}
+
+void World::setSystemEnabled(SystemID id, bool enabled) {
+    systemMgr.setEnabled(id, enabled);
+}
+
+void World::runSystems(float dt) {
+    systemMgr.run(dt);
+}
+
+// timings of the last runSystems()
+const ScheduleStats& World::getScheduleStats() const {
+    return systemMgr.getStats();
+}
+
+// worker threads of the World, start on the first job so a World that never
+// runs systems or parallel work never starts them
+JobSystem& World::getJobSystem() {
+    return jobSystem;
+}
+
+// =============================================================================
+// World Memory Functions
+// =============================================================================
+
+// moves rows out of sparse chunks for at most budget seconds, see
+// ChunkManager::compact()
+CompactionStats World::compact(double budget) {
+    return chunkMgr.compact(budget);
+}
+
+float World::getFillFactor() const {
+    return chunkMgr.getFillFactor();
+}
+
+// =============================================================================
+// World Stats Functions
+// =============================================================================
+
+// fills stats (see ecs/stats.hpp) and restarts the structural change counters,
+// so sampling once per frame gives per frame counts
+void World::sampleStats(WorldStats& stats) {
+    chunkMgr.getStats(stats);
+    stats.freeEntityIDs = static_cast<uint32_t>(entityMgr.getFreeCount());
+    chunkMgr.resetCounters();
+}
+
 // =============================================================================
 // World Miscellaneous Functions
 // =============================================================================
 
+// zero chunk buffers when they are freed (off by default)
+void World::setZeroFreedChunks(bool zero) {
+    chunkMgr.setZeroFreedChunks(zero);
+}
+
+uint32_t World::getVersion() const {
+    return chunkMgr.getVersion();
+}
+
 void World::print() {
     archetypeMgr.print();
     chunkMgr.print();
     componentMgr.print();
     entityMgr.print();
+    eventMgr.print();
+    queryMgr.print();
+    sharedMgr.print();
+    systemMgr.print();
+}
+
+// =============================================================================
+// World Private Functions
+// =============================================================================
+
+ArchetypeID World::_getArchetypeWithShared(ArchetypeID aID, SharedSetID sID) {
+    if (sID == SHARED_SET_ID_EMPTY) return aID;
+    ArchetypeMask mask = archetypeMgr.getArchetype(aID).getMask() | sharedMgr.getSet(sID).mask;
+    return archetypeMgr.getOrCreateArchetype(mask);
 }
 
 } // namespace ECS
\ No newline at end of file
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "components/hierarchy.hpp"
+#include "components/transform.hpp"
+#include "ecs/world.hpp"
+
+#include <algorithm> // for std::stable_sort
+#include <vector>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+#endif
+
+// =============================================================================
+// Hierarchy Kernels
+//
+// Reference chunk kernels for Query::forEachChunk(), see movement_system.hpp.
+// =============================================================================
+
+// pos = parent + offset
+// Position and LocalOffset columns are both flat float arrays of length 2n and
+// the parent position is broadcast as x, y, x, y, ... so the propagation is a
+// single element-wise add over 2n floats.
+inline void offsetKernel(
+        ECS::ChunkIdx n,
+        Position* ECS_RESTRICT pos,
+        const LocalOffset* ECS_RESTRICT offset,
+        Position parent) {
+    float* p = reinterpret_cast<float*>(pos);
+    const float* o = reinterpret_cast<const float*>(offset);
+    size_t count = size_t(n) * 2;
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    __m256 vparent = _mm256_castpd_ps(_mm256_broadcast_sd(reinterpret_cast<const double*>(&parent)));
+    for (; i + 8 <= count; i += 8) {
+        __m256 vo = _mm256_loadu_ps(o + i);
+        _mm256_storeu_ps(p + i, _mm256_add_ps(vparent, vo));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128 vparent = _mm_castpd_ps(_mm_load1_pd(reinterpret_cast<const double*>(&parent)));
+    for (; i + 4 <= count; i += 4) {
+        __m128 vo = _mm_loadu_ps(o + i);
+        _mm_storeu_ps(p + i, _mm_add_ps(vparent, vo));
+    }
+#endif
+
+    const float xy[2] = {parent.x, parent.y};
+    for (; i < count; i++) {
+        p[i] = xy[i & 1] + o[i];
+    }
+}
+
+// =============================================================================
+// HierarchySystem
+//
+// Keeps the Position of every child at its parent Position plus LocalOffset
+// (e.g. units following their group flag in formation). Children are visited
+// a run of rows with the same Parent at a time, with one parent lookup per
+// run, parents before their children so nested hierarchies settle in a single
+// update. Run it after the systems that move the parents, e.g. MovementSystem.
+//
+// Parent and LocalOffset must be registered with the World. A formation
+// created in one batch is a single run per chunk:
+//
+//   world.createEntities(n, gID, Position{}, LocalOffset{}, hierarchy.makeParent(flag));
+//
+// Children of a parent that was removed keep their last Position and count as
+// roots, also after the parent's ID is reused by another entity. Parents add
+// no chunk lists or shared values, so formations may come and go all game.
+// =============================================================================
+
+class HierarchySystem {
+public:
+    HierarchySystem(ECS::World& world);
+
+    // relationship functions
+    Parent makeParent(ECS::EntityID parent);
+    void attach(ECS::EntityID child, ECS::EntityID parent, LocalOffset offset);
+    void detach(ECS::EntityID child);
+    ECS::EntityID getParent(ECS::EntityID child);
+
+    void update();
+
+private:
+    // rows [0, n) of a chunk sharing one parent
+    struct Run {
+        uint32_t depth;
+        ECS::ChunkIdx n;
+        Position* pos;
+        const LocalOffset* offset;
+        Parent parent;
+    };
+
+    const Parent* _getParent(ECS::EntityID eID);
+    bool _isAlive(const Parent& parent);
+    uint32_t _getDepth(ECS::EntityID parent);
+
+    ECS::World& world;
+    ECS::Query<Position, const LocalOffset, const Parent> children;
+
+    // runs sorted by depth, rebuilt every update (one entry per parent and
+    // chunk, not per child)
+    std::vector<Run> runs;
+};
+
+HierarchySystem::HierarchySystem(ECS::World& world)
+    : world(world),
+      children(world.query<Position, const LocalOffset, const Parent>()),
+      runs({}) {}
+
+// the Parent value of a live entity, e.g. as a prototype for createEntities()
+Parent HierarchySystem::makeParent(ECS::EntityID parent) {
+    ASSERT(world.hasEntity(parent), "Parent entity id does not exist");
+    return Parent{parent, world.getEntity(parent).getGeneration()};
+}
+
+// a child that already has a parent is updated in place, otherwise it moves
+// to the end of the children archetype next to the children attached before it
+void HierarchySystem::attach(ECS::EntityID child, ECS::EntityID parent, LocalOffset offset) {
+    ASSERT(world.hasEntity(parent), "Parent entity id does not exist");
+    for (ECS::EntityID p = parent; p != ECS::ENTITY_ID_NULL; p = getParent(p)) {
+        ASSERT(p != child, "Entity cannot be attached to its own descendant");
+    }
+
+    const ECS::Entity& entity = world.getEntity(child);
+    ECS::Chunk& chunk = world.getChunk(entity.getChunkID());
+    if (chunk.hasComponent<LocalOffset>()) {
+        chunk.data<LocalOffset>()[entity.getChunkIdx()] = offset;
+    } else {
+        world.insertComponentIntoEntity<LocalOffset>(child, LocalOffset(offset));
+    }
+
+    const ECS::Entity& moved = world.getEntity(child);
+    ECS::Chunk& dst = world.getChunk(moved.getChunkID());
+    if (dst.hasComponent<Parent>()) {
+        dst.data<Parent>()[moved.getChunkIdx()] = makeParent(parent);
+    } else {
+        world.insertComponentIntoEntity<Parent>(child, makeParent(parent));
+    }
+}
+
+// the child keeps its Position and LocalOffset
+void HierarchySystem::detach(ECS::EntityID child) {
+    world.removeComponentFromEntity<Parent>(child);
+}
+
+// returns ENTITY_ID_NULL for a root or a child of a removed parent
+ECS::EntityID HierarchySystem::getParent(ECS::EntityID child) {
+    const Parent* parent = _getParent(child);
+    return parent ? parent->entity : ECS::ENTITY_ID_NULL;
+}
+
+void HierarchySystem::update() {
+    // one linear pass over the Parent column splits chunks into runs
+    runs.clear();
+    children.forEach([this](
+            ECS::ChunkIdx n,
+            const ECS::EntityID*,
+            Position* pos,
+            const LocalOffset* offset,
+            const Parent* parent) {
+        for (ECS::ChunkIdx beg = 0, end = 0; beg < n; beg = end) {
+            end = beg + 1;
+            while (end < n &&
+                   parent[end].entity == parent[beg].entity &&
+                   parent[end].generation == parent[beg].generation)
+                end++;
+
+            if (!_isAlive(parent[beg])) continue;
+            ECS::ChunkIdx count = static_cast<ECS::ChunkIdx>(end - beg);
+            runs.push_back({_getDepth(parent[beg].entity), count, pos + beg, offset + beg, parent[beg]});
+        }
+    });
+    std::stable_sort(runs.begin(), runs.end(), [](const Run& a, const Run& b) {
+        return a.depth < b.depth;
+    });
+
+    for (const Run& run : runs) {
+        const ECS::Entity& entity = world.getEntity(run.parent.entity);
+        const ECS::Chunk& chunk = world.getChunk(entity.getChunkID());
+        if (!chunk.hasComponent<Position>()) continue;
+
+        offsetKernel(run.n, run.pos, run.offset, chunk.data<Position>()[entity.getChunkIdx()]);
+    }
+}
+
+// nullptr for a root, a removed entity or a child of a removed parent
+const Parent* HierarchySystem::_getParent(ECS::EntityID eID) {
+    if (!world.hasEntity(eID)) return nullptr;
+    const ECS::Entity& entity = world.getEntity(eID);
+    const ECS::Chunk& chunk = world.getChunk(entity.getChunkID());
+    if (!chunk.hasComponent<Parent>()) return nullptr;
+
+    const Parent* parent = &chunk.data<Parent>()[entity.getChunkIdx()];
+    return _isAlive(*parent) ? parent : nullptr;
+}
+
+// false once the parent was removed, even if its ID was reused since
+bool HierarchySystem::_isAlive(const Parent& parent) {
+    return world.hasEntity(parent.entity) &&
+           world.getEntity(parent.entity).getGeneration() == parent.generation;
+}
+
+// children of a root are at depth 1
+uint32_t HierarchySystem::_getDepth(ECS::EntityID parent) {
+    uint32_t depth = 1;
+    for (const Parent* p = _getParent(parent); p; p = _getParent(p->entity)) {
+        depth++;
+    }
+    return depth;
+}
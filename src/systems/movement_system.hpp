@@ -0,0 +1,135 @@
+#pragma once
+
+#include "components/transform.hpp"
+#include "ecs/world.hpp"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+#endif
+
+// =============================================================================
+// Movement Kernels
+//
+// Reference chunk kernels for Query::forEachChunk(). Column pointers are only
+// element aligned when enable bits split a chunk into runs, so the kernels use
+// unaligned loads (as fast as aligned ones on aligned data), and the row count
+// is arbitrary so every kernel finishes with a scalar tail.
+//
+// The widest instruction set enabled at compile time is used (build with
+// GAME_ENABLE_AVX2=ON for AVX2), with a scalar fallback for other targets.
+// =============================================================================
+
+// pos += vel * dt
+// Position and Velocity columns are both flat float arrays of length 2n, so
+// the integration is a single element-wise multiply-add over 2n floats.
+inline void moveKernel(
+        ECS::ChunkIdx n,
+        Position* ECS_RESTRICT pos,
+        const Velocity* ECS_RESTRICT vel,
+        float dt) {
+    float* p = reinterpret_cast<float*>(pos);
+    const float* v = reinterpret_cast<const float*>(vel);
+    size_t count = size_t(n) * 2;
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    __m256 vdt = _mm256_set1_ps(dt);
+    for (; i + 8 <= count; i += 8) {
+        __m256 vp = _mm256_loadu_ps(p + i);
+        __m256 vv = _mm256_loadu_ps(v + i);
+        _mm256_storeu_ps(p + i, _mm256_add_ps(vp, _mm256_mul_ps(vv, vdt)));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    __m128 vdt = _mm_set1_ps(dt);
+    for (; i + 4 <= count; i += 4) {
+        __m128 vp = _mm_loadu_ps(p + i);
+        __m128 vv = _mm_loadu_ps(v + i);
+        _mm_storeu_ps(p + i, _mm_add_ps(vp, _mm_mul_ps(vv, vdt)));
+    }
+#endif
+
+    for (; i < count; i++) {
+        p[i] += v[i] * dt;
+    }
+}
+
+// recenters each box on its position keeping its size (BoundingBox::moveTo)
+// min = pos - (max - min) / 2, max = pos + (max - min) / 2
+inline void boundsKernel(
+        ECS::ChunkIdx n,
+        const Position* ECS_RESTRICT pos,
+        Bounds* ECS_RESTRICT bounds) {
+    float* b = reinterpret_cast<float*>(bounds);
+    const float* p = reinterpret_cast<const float*>(pos);
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    // two entities per register: [minX, minY, maxX, maxY | minX, minY, maxX, maxY]
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 sign = _mm256_setr_ps(-1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f);
+    const __m256i dupPos = _mm256_setr_epi32(0, 1, 0, 1, 2, 3, 2, 3);
+    for (; i + 2 <= n; i += 2) {
+        __m256 vb = _mm256_loadu_ps(b + i * 4);
+        __m256 vmax = _mm256_permute_ps(vb, _MM_SHUFFLE(3, 2, 3, 2));         // maxX, maxY, maxX, maxY
+        __m256 vmin = _mm256_permute_ps(vb, _MM_SHUFFLE(1, 0, 1, 0));         // minX, minY, minX, minY
+        __m256 vext = _mm256_mul_ps(_mm256_sub_ps(vmax, vmin), half);         // halfW, halfH, halfW, halfH
+        __m128 vp2 = _mm_loadu_ps(p + i * 2);                                 // x0, y0, x1, y1
+        __m256 vp = _mm256_permutevar8x32_ps(_mm256_castps128_ps256(vp2), dupPos); // x0, y0, x0, y0 | x1, y1, x1, y1
+        _mm256_storeu_ps(b + i * 4, _mm256_add_ps(vp, _mm256_mul_ps(vext, sign)));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    // one entity per register: [minX, minY, maxX, maxY]
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 sign = _mm_setr_ps(-1.0f, -1.0f, 1.0f, 1.0f);
+    for (; i < n; i++) {
+        __m128 vb = _mm_loadu_ps(b + i * 4);
+        __m128 vmax = _mm_movehl_ps(vb, vb);                                  // maxX, maxY, maxX, maxY
+        __m128 vext = _mm_mul_ps(_mm_sub_ps(vmax, vb), half);                 // halfW, halfH, -, -
+        vext = _mm_movelh_ps(vext, vext);                                     // halfW, halfH, halfW, halfH
+        __m128 vp = _mm_castpd_ps(_mm_load1_pd(reinterpret_cast<const double*>(p + i * 2))); // x, y, x, y
+        _mm_storeu_ps(b + i * 4, _mm_add_ps(vp, _mm_mul_ps(vext, sign)));
+    }
+#endif
+
+    for (; i < n; i++) {
+        Bounds& box = bounds[i];
+        float halfW = (box.maxX - box.minX) * 0.5f;
+        float halfH = (box.maxY - box.minY) * 0.5f;
+        box.minX = pos[i].x - halfW;  box.maxX = pos[i].x + halfW;
+        box.minY = pos[i].y - halfH;  box.maxY = pos[i].y + halfH;
+    }
+}
+
+// =============================================================================
+// MovementSystem
+//
+// Integrates velocity into position, then refits the bounds of the entities
+// whose position changed (chunks of idle entities are skipped entirely).
+// =============================================================================
+
+class MovementSystem {
+public:
+    MovementSystem(ECS::World& world);
+
+    void update(float dt);
+
+private:
+    ECS::Query<Position, const Velocity> movers;
+    ECS::Query<const Position, Bounds, ECS::Changed<Position>> boxes;
+};
+
+MovementSystem::MovementSystem(ECS::World& world)
+    : movers(world.query<Position, const Velocity>()),
+      boxes(world.query<const Position, Bounds, ECS::Changed<Position>>()) {}
+
+void MovementSystem::update(float dt) {
+    movers.forEachChunk([dt](ECS::ChunkIdx n, Position* ECS_RESTRICT pos, const Velocity* ECS_RESTRICT vel) {
+        moveKernel(n, pos, vel, dt);
+    });
+
+    boxes.forEachChunk([](ECS::ChunkIdx n, const Position* ECS_RESTRICT pos, Bounds* ECS_RESTRICT bounds) {
+        boundsKernel(n, pos, bounds);
+    });
+}
\ No newline at end of file
@@ -1,11 +1,13 @@
 #pragma once
 
 #include "common/types.hpp"
+#include "ecs/stats.hpp"
 #include "graphics/camera.hpp"
 #include "graphics/font.hpp"
 
 #include <glm/glm.hpp>
 
+#include <cstdio> // for std::snprintf
 #include <string>
 #include <vector>
 
@@ -28,12 +30,14 @@ public:
     DebugOverlay(bool isActive = false);
     void toggleActive() { isActive = !isActive; };
     void update(const Camera& camera, FrameState& frame);
+    void updateECSStats(const ECS::WorldStats& stats);
     void render(const Camera& camera);
 
 private:
     bool isActive = false;
     Font font;
     std::vector<DebugOverlayLine> lines;
+    size_t ecsLine; // first of the ECS stats lines
 };
 
 DebugOverlay::DebugOverlay(bool isActive) : isActive(isActive) {
@@ -47,6 +51,12 @@ DebugOverlay::DebugOverlay(bool isActive) : isActive(isActive) {
     lines.push_back(DebugOverlayLine("test", pt, {x, y+=spacing}));
     lines.push_back(DebugOverlayLine("test", pt, {x, y+=spacing}));
     lines.push_back(DebugOverlayLine("test", pt, {x, y+=spacing}));
+
+    ecsLine = lines.size();
+    lines.push_back(DebugOverlayLine("", pt, {x, y+=spacing}));
+    lines.push_back(DebugOverlayLine("", pt, {x, y+=spacing}));
+    lines.push_back(DebugOverlayLine("", pt, {x, y+=spacing}));
+    lines.push_back(DebugOverlayLine("", pt, {x, y+=spacing}));
 }
 
 void DebugOverlay::update(const Camera& camera, FrameState& frame) {
@@ -74,6 +84,40 @@ void DebugOverlay::update(const Camera& camera, FrameState& frame) {
     frame.states.isDebugActive = isActive;
 }
 
+// call with a World::sampleStats() result once per frame
+void DebugOverlay::updateECSStats(const ECS::WorldStats& stats) {
+    if (!isActive) return;
+
+    // archetype wasting the most chunk memory
+    const ECS::ArchetypeStats* worst = nullptr;
+    for (const ECS::ArchetypeStats& a : stats.archetypes) {
+        if (!worst || a.getWastedBytes() > worst->getWastedBytes()) worst = &a;
+    }
+
+    const ECS::OccupancyStats& total = stats.total;
+    const ECS::StructuralCounters& frame = stats.frame;
+    char text[128];
+
+    std::snprintf(text, sizeof(text), "ECS: %u entities, %u chunks, %.1f%% fill, %zu KB wasted",
+        total.entities, total.chunks, total.getFillFactor() * 100.0f, total.getWastedBytes() / 1024);
+    lines[ecsLine + 0].text = text;
+
+    std::snprintf(text, sizeof(text), "ECS: %zu archetypes, %u lists, %zu groups, free chunks %u, free entities %u",
+        stats.archetypes.size(), total.lists, stats.groups.size(), stats.freeChunkIDs, stats.freeEntityIDs);
+    lines[ecsLine + 1].text = text;
+
+    std::snprintf(text, sizeof(text), "ECS frame: +%u -%u entities, %u moved, +%u -%u chunks, +%u lists",
+        frame.entitiesCreated, frame.entitiesRemoved, frame.rowsMoved,
+        frame.chunksAllocated, frame.chunksFreed, frame.listsCreated);
+    lines[ecsLine + 2].text = text;
+
+    if (worst) {
+        std::snprintf(text, sizeof(text), "ECS worst: archetype %u, %u entities, %.1f%% fill, %.0f B/entity",
+            unsigned(worst->id), worst->entities, worst->getFillFactor() * 100.0f, worst->getBytesPerEntity());
+        lines[ecsLine + 3].text = text;
+    }
+}
+
 void DebugOverlay::render(const Camera& camera) {
     if (!isActive) return;
 
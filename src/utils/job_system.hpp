@@ -0,0 +1,548 @@
+#pragma once
+
+#include <algorithm> // for std::max, std::min
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// =============================================================================
+// JobCounter
+//
+// Counts the unfinished jobs started with it (see JobSystem::run()). Wait for
+// it with JobSystem::wait() or start jobs after it with JobSystem::runAfter().
+// A counter can be reused once it is done, and must outlive its jobs.
+// =============================================================================
+
+class JobCounter {
+    friend class JobSystem;
+
+public:
+    JobCounter() : count(0) {}
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool isDone() const { return count.load(std::memory_order_acquire) == 0; }
+    uint32_t getCount() const { return count.load(std::memory_order_acquire); }
+
+private:
+    std::atomic<uint32_t> count;
+};
+
+struct Job {
+    std::function<void()> fn;
+    JobCounter* counter;          // decremented when fn returns, may be nullptr
+    const JobCounter* dependency; // runAfter() jobs wait for it to be done
+};
+
+// =============================================================================
+// WorkStealingDeque
+//
+// Chase-Lev deque of fixed capacity. The owner thread pushes and pops at the
+// bottom (LIFO, so it keeps working on hot data), any thread steals from the
+// top (FIFO, so thieves take the oldest and usually largest jobs). Orderings
+// follow Le et al., "Correct and Efficient Work-Stealing for Weak Memory
+// Models" (2013), with seq_cst accesses in place of standalone fences.
+// =============================================================================
+
+class WorkStealingDeque {
+public:
+    static constexpr int64_t CAPACITY = 4096; // power of two
+
+    WorkStealingDeque() : top(0), bottom(0), buffer() {}
+
+    bool push(Job* job); // owner only, false when full
+    Job* pop();          // owner only
+    Job* steal();        // any thread
+    bool isEmpty() const;
+
+private:
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    alignas(64) std::array<std::atomic<Job*>, CAPACITY> buffer;
+};
+
+inline bool WorkStealingDeque::push(Job* job) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    if (b - t >= CAPACITY) return false;
+
+    buffer[b & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+    bottom.store(b + 1, std::memory_order_release);
+    return true;
+}
+
+inline Job* WorkStealingDeque::pop() {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    bottom.store(b, std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_seq_cst);
+
+    if (t > b) {
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job* job = buffer[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (t == b) {
+        // last job, race the thieves for it
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            job = nullptr;
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+inline Job* WorkStealingDeque::steal() {
+    int64_t t = top.load(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_seq_cst);
+    if (t >= b) return nullptr;
+
+    Job* job = buffer[t & (CAPACITY - 1)].load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return nullptr;
+    return job;
+}
+
+inline bool WorkStealingDeque::isEmpty() const {
+    int64_t t = top.load(std::memory_order_relaxed);
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    return t >= b;
+}
+
+// =============================================================================
+// JobSystem
+//
+// Work-stealing job scheduler with one deque per thread. Thread 0 is the
+// thread that created the JobSystem, threads 1 to N-1 are workers started on
+// the first job. Jobs started from other threads go through a shared queue.
+//
+// A thread waiting on a counter runs jobs (its own, queued or stolen) until
+// the counter is done, so waiting inside a job is safe and the waiting thread
+// is never idle while there is work:
+//
+//   JobCounter counter;
+//   jobs.run([&] { buildNavMesh(); }, &counter);
+//   jobs.run([&] { extractRenderData(); }, &counter);
+//   jobs.runAfter(counter, [&] { submitFrame(); });
+//   jobs.wait(counter);
+//
+//   jobs.parallelFor(0, units.size(), [&](size_t beg, size_t end) {
+//       for (size_t i = beg; i < end; i++) { ... }
+//   });
+//
+// Idle workers spin briefly, then sleep until woken by a new job.
+//
+// NOTE: jobs still queued when the JobSystem is destroyed are dropped, wait
+//       on every counter first.
+// =============================================================================
+
+class JobSystem {
+public:
+    static constexpr int    THREAD_INDEX_NULL = -1; // threads the JobSystem does not know
+    static constexpr size_t SPIN_COUNT        = 64; // idle rounds before a worker sleeps
+
+    JobSystem(size_t threadCount = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    void run(std::function<void()> fn, JobCounter* counter = nullptr);
+    void runAfter(const JobCounter& dependency, std::function<void()> fn, JobCounter* counter = nullptr);
+    void wait(JobCounter& counter);
+
+    template <typename Fn>
+    void parallelFor(size_t begin, size_t end, Fn&& fn, size_t minGrain = 1);
+
+    size_t getThreadCount() const { return threadCount; }
+    int getThreadIndex() const;
+
+private:
+    struct alignas(64) Worker {
+        WorkStealingDeque deque;
+    };
+
+    struct ThreadContext {
+        const JobSystem* system;
+        int index;
+    };
+
+    template <typename Fn>
+    void _parallelForRange(size_t begin, size_t end, size_t grain, Fn& fn, JobCounter& counter);
+
+    void _start();
+    void _workerLoop(int index);
+    void _push(Job* job);
+    Job* _find(int index);
+    bool _hasWork() const;
+    void _execute(Job* job);
+    void _releaseParked(const JobCounter* counter);
+    void _wakeOne();
+    static ThreadContext& _getContext();
+
+    size_t threadCount; // creating thread included
+    std::thread::id ownerID;
+    std::unique_ptr<Worker[]> workers; // deque per thread, [0] is the owner
+    std::vector<std::thread> threads;
+    std::once_flag startFlag;
+
+    // jobs from threads without a deque
+    std::mutex injectMutex;
+    std::deque<Job*> injected;
+    std::atomic<size_t> injectedCount;
+
+    // runAfter() jobs whose dependency is not done yet
+    std::mutex parkMutex;
+    std::vector<Job*> parked;
+    std::atomic<size_t> parkedCount;
+
+    // sleeping workers
+    std::mutex sleepMutex;
+    std::condition_variable sleepCV;
+    std::atomic<uint32_t> sleepers;
+    uint32_t signals; // guarded by sleepMutex
+    std::atomic<bool> stopping;
+};
+
+// =============================================================================
+// JobSystem Functions
+// =============================================================================
+
+// threadCount 0 uses one thread per hardware thread, 1 runs every job on the
+// thread that waits for it
+inline JobSystem::JobSystem(size_t threadCount)
+    : threadCount(threadCount ? threadCount : std::max<size_t>(1, std::thread::hardware_concurrency())),
+      ownerID(std::this_thread::get_id()),
+      workers(nullptr),
+      threads(),
+      startFlag(),
+      injectMutex(),
+      injected(),
+      injectedCount(0),
+      parkMutex(),
+      parked(),
+      parkedCount(0),
+      sleepMutex(),
+      sleepCV(),
+      sleepers(0),
+      signals(0),
+      stopping(false) {
+    workers.reset(new Worker[this->threadCount]);
+}
+
+inline JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping.store(true);
+    }
+    sleepCV.notify_all();
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < threadCount; i++) {
+        while (Job* job = workers[i].deque.steal()) delete job;
+    }
+    for (Job* job : injected) delete job;
+    for (Job* job : parked) delete job;
+}
+
+inline void JobSystem::run(std::function<void()> fn, JobCounter* counter) {
+    if (counter) counter->count.fetch_add(1, std::memory_order_relaxed);
+    _push(new Job{std::move(fn), counter, nullptr});
+}
+
+// the job starts once dependency is done (at once if it already is)
+inline void JobSystem::runAfter(const JobCounter& dependency, std::function<void()> fn, JobCounter* counter) {
+    if (counter) counter->count.fetch_add(1, std::memory_order_relaxed);
+    Job* job = new Job{std::move(fn), counter, &dependency};
+
+    // counted before the check so a concurrent _releaseParked() sees it
+    parkedCount.fetch_add(1, std::memory_order_seq_cst);
+    {
+        std::lock_guard<std::mutex> lock(parkMutex);
+        if (dependency.count.load(std::memory_order_seq_cst) != 0) {
+            parked.push_back(job);
+            return;
+        }
+    }
+    parkedCount.fetch_sub(1, std::memory_order_relaxed);
+    _push(job);
+}
+
+// runs jobs on this thread until the counter is done
+inline void JobSystem::wait(JobCounter& counter) {
+    int index = getThreadIndex();
+    while (!counter.isDone()) {
+        Job* job = _find(index);
+        if (job) _execute(job);
+        else     std::this_thread::yield();
+    }
+}
+
+// Calls fn(beg, end) on disjoint subranges covering [begin, end) and returns
+// when all have run. Ranges split lazily: a job splits off half of what is
+// left only while its own deque is empty (thieves took the earlier halves),
+// down to a grain of max(minGrain, n / (8 * threads)). Even loops end up with
+// about one job per thread, uneven loops keep splitting where work remains.
+template <typename Fn>
+void JobSystem::parallelFor(size_t begin, size_t end, Fn&& fn, size_t minGrain) {
+    if (begin >= end) return;
+
+    size_t n = end - begin;
+    size_t grain = std::max<size_t>({minGrain, size_t(1), n / (threadCount * 8)});
+    if (threadCount == 1 || n <= grain) {
+        fn(begin, end);
+        return;
+    }
+
+    JobCounter counter;
+    _parallelForRange(begin, end, grain, fn, counter);
+    wait(counter);
+}
+
+// index of the calling thread (0 is the creating thread), THREAD_INDEX_NULL
+// for other threads
+inline int JobSystem::getThreadIndex() const {
+    const ThreadContext& context = _getContext();
+    if (context.system == this) return context.index;
+    if (std::this_thread::get_id() == ownerID) return 0;
+    return THREAD_INDEX_NULL;
+}
+
+// =============================================================================
+// JobSystem Private Functions
+// =============================================================================
+
+template <typename Fn>
+void JobSystem::_parallelForRange(size_t begin, size_t end, size_t grain, Fn& fn, JobCounter& counter) {
+    int index = getThreadIndex();
+    while (begin < end) {
+        bool hungry = (index == THREAD_INDEX_NULL) || workers[index].deque.isEmpty();
+        if (end - begin > grain && hungry) {
+            size_t mid = begin + (end - begin) / 2;
+            run([this, mid, end, grain, &fn, &counter] {
+                _parallelForRange(mid, end, grain, fn, counter);
+            }, &counter);
+            end = mid;
+            continue;
+        }
+
+        size_t stop = std::min(begin + grain, end);
+        fn(begin, stop);
+        begin = stop;
+    }
+}
+
+inline void JobSystem::_start() {
+    std::call_once(startFlag, [this] {
+        for (size_t i = 1; i < threadCount; i++) {
+            threads.emplace_back(&JobSystem::_workerLoop, this, static_cast<int>(i));
+        }
+    });
+}
+
+inline void JobSystem::_workerLoop(int index) {
+    _getContext() = {this, index};
+
+    size_t spins = 0;
+    while (!stopping.load(std::memory_order_relaxed)) {
+        if (Job* job = _find(index)) {
+            _execute(job);
+            spins = 0;
+            continue;
+        }
+
+        if (++spins < SPIN_COUNT) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // checked again after counting as a sleeper so a push racing with
+        // the sleep is seen either here or by the pusher (the timeout bounds
+        // the latency of any wakeup still missed)
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            if (!_hasWork()) {
+                sleepCV.wait_for(lock, std::chrono::milliseconds(1), [this] {
+                    return signals > 0 || stopping.load(std::memory_order_relaxed);
+                });
+            }
+            if (signals > 0) signals--;
+        }
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+        spins = 0;
+    }
+}
+
+// own deque, or the shared queue for other threads (a full deque runs the job
+// at once)
+inline void JobSystem::_push(Job* job) {
+    _start();
+
+    int index = getThreadIndex();
+    if (index == THREAD_INDEX_NULL) {
+        std::lock_guard<std::mutex> lock(injectMutex);
+        injected.push_back(job);
+        injectedCount.fetch_add(1, std::memory_order_seq_cst);
+    } else if (!workers[index].deque.push(job)) {
+        _execute(job);
+        return;
+    }
+
+    _wakeOne();
+}
+
+// own deque first, then the shared queue, then the other deques
+inline Job* JobSystem::_find(int index) {
+    if (index != THREAD_INDEX_NULL) {
+        if (Job* job = workers[index].deque.pop()) return job;
+    }
+
+    if (injectedCount.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(injectMutex);
+        if (!injected.empty()) {
+            Job* job = injected.front();
+            injected.pop_front();
+            injectedCount.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    size_t self = (index == THREAD_INDEX_NULL) ? 0 : size_t(index);
+    for (size_t i = 1; i <= threadCount; i++) {
+        size_t victim = (self + i) % threadCount;
+        if (victim == size_t(index)) continue;
+        if (Job* job = workers[victim].deque.steal()) return job;
+    }
+    return nullptr;
+}
+
+inline bool JobSystem::_hasWork() const {
+    if (injectedCount.load(std::memory_order_seq_cst) > 0) return true;
+    for (size_t i = 0; i < threadCount; i++) {
+        if (!workers[i].deque.isEmpty()) return true;
+    }
+    return false;
+}
+
+inline void JobSystem::_execute(Job* job) {
+    job->fn();
+
+    // the counter may be destroyed by its waiter as soon as it reaches zero,
+    // so only its address is used after the decrement
+    JobCounter* counter = job->counter;
+    delete job;
+    if (counter && counter->count.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+        _releaseParked(counter);
+    }
+}
+
+// pushes the runAfter() jobs waiting for the counter
+inline void JobSystem::_releaseParked(const JobCounter* counter) {
+    if (parkedCount.load(std::memory_order_seq_cst) == 0) return;
+
+    std::vector<Job*> released;
+    {
+        std::lock_guard<std::mutex> lock(parkMutex);
+        for (size_t i = 0; i < parked.size();) {
+            if (parked[i]->dependency == counter) {
+                released.push_back(parked[i]);
+                parked[i] = parked.back();
+                parked.pop_back();
+            } else {
+                i++;
+            }
+        }
+    }
+    parkedCount.fetch_sub(released.size(), std::memory_order_relaxed);
+
+    for (Job* job : released) _push(job);
+}
+
+inline void JobSystem::_wakeOne() {
+    std::atomic_thread_fence(std::memory_order_seq_cst); // order the push before the load
+    if (sleepers.load(std::memory_order_seq_cst) == 0) return;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        if (signals < threadCount) signals++;
+    }
+    sleepCV.notify_one();
+}
+
+inline JobSystem::ThreadContext& JobSystem::_getContext() {
+    thread_local ThreadContext context{nullptr, THREAD_INDEX_NULL};
+    return context;
+}
+
+// =============================================================================
+// PerThread
+//
+// One value per JobSystem thread (plus one for threads it does not know), each
+// on its own cache line. Jobs accumulate into local() without synchronization
+// and the caller combines the values once the jobs are done:
+//
+//   PerThread<float> sums(jobs, 0.0f);
+//   jobs.parallelFor(0, n, [&](size_t beg, size_t end) {
+//       for (size_t i = beg; i < end; i++) sums.local() += values[i];
+//   });
+//   float total = 0.0f;
+//   sums.forEach([&](float sum) { total += sum; });
+//
+// =============================================================================
+
+template <typename T>
+class PerThread {
+public:
+    PerThread(const JobSystem& jobs, const T& value = T())
+        : jobs(&jobs),
+          slots(jobs.getThreadCount() + 1, Slot{value}) {}
+
+    T& local();
+    T& operator[](size_t index) { return slots[index].value; }
+    size_t size() const { return slots.size(); }
+
+    template <typename Fn>
+    void forEach(Fn&& fn);
+    void reset(const T& value = T());
+
+private:
+    struct alignas(64) Slot {
+        T value;
+    };
+
+    const JobSystem* jobs;
+    std::vector<Slot> slots; // [getThreadCount()] is shared by unknown threads
+};
+
+// the value of the calling thread
+// NOTE: threads the JobSystem does not know share one value, so only one of
+//       them may use local() at a time
+template <typename T>
+T& PerThread<T>::local() {
+    int index = jobs->getThreadIndex();
+    if (index == JobSystem::THREAD_INDEX_NULL) index = static_cast<int>(slots.size() - 1);
+    return slots[index].value;
+}
+
+template <typename T>
+template <typename Fn>
+void PerThread<T>::forEach(Fn&& fn) {
+    for (Slot& slot : slots) fn(slot.value);
+}
+
+template <typename T>
+void PerThread<T>::reset(const T& value) {
+    for (Slot& slot : slots) slot.value = value;
+}